@@ -0,0 +1,853 @@
+// --------------------------------------------------------------------------
+//              Ghost Busters — CPU-side micro benchmarks
+//    Headless: no window or GL context is created, only the CPU work that
+//    the game does per frame is measured. Run with `make bench`.
+// --------------------------------------------------------------------------
+
+#include "glad.h"
+#include "glm/glm/glm.hpp"
+#include "glm/glm/gtc/matrix_transform.hpp"
+#include "glm/glm/gtc/type_ptr.hpp"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "../src/rect_batch.h"
+#include "../src/asset_pack.h"
+#include "../src/components.h"
+#include "../src/rollback.h"
+#include "../src/snapshot.h"
+#include "../src/snapshot_codec.h"
+#include "../src/batch_env.h"
+#include "../src/audio_mixer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// =====================[ Helpers ]=====================
+static double nowSec() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// keeps the optimizer from deleting benchmarked work
+static volatile float g_sink;
+
+static void report(const char* name, double seconds, double items, const char* unit) {
+    printf("  %-44s %10.2f ns/%s\n", name, seconds * 1e9 / items, unit);
+}
+
+// =====================[ Rect transform ]=====================
+// Old path: two mat4 ops + a 16-float store per rect.
+// New path: RectBatch::push, i.e. four float stores, a color pack and three
+// cached words.
+static void benchRectTransform() {
+    printf("[rect transform]\n");
+    const int RECTS = 4096, FRAMES = 500;
+    std::vector<glm::vec3> pos(RECTS);
+    std::vector<glm::vec2> size(RECTS);
+    for (int i = 0; i < RECTS; ++i) {
+        pos[i]  = glm::vec3((i % 64) / 32.0f - 1.0f, (i / 64) / 32.0f - 1.0f, 0.0f);
+        size[i] = glm::vec2(0.01f + (i % 7) * 0.002f);
+    }
+
+    std::vector<float> uploaded(16 * RECTS);   // stands in for glUniformMatrix4fv
+    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.01f, -0.01f, 0.0f));
+    double t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        for (int i = 0; i < RECTS; ++i) {
+            glm::mat4 t = view;
+            t = glm::translate(t, pos[i]);
+            t = glm::scale(t, glm::vec3(size[i].x, size[i].y, 1.0f));
+            memcpy(&uploaded[16 * i], glm::value_ptr(t), 16 * sizeof(float));
+        }
+        g_sink = uploaded[(f * 17) % uploaded.size()];
+    }
+    report("mat4 translate+scale (before)", nowSec() - t0, (double)RECTS * FRAMES, "rect");
+
+    RectBatch batch;
+    batch.reserve(RECTS);
+    t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        batch.clear();
+        for (int i = 0; i < RECTS; ++i)
+            batch.push(pos[i].x, pos[i].y, size[i].x, size[i].y, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+        g_sink = batch.rects[(f * 17) % RECTS].x;
+    }
+    report("RectBatch::push offset/scale (after)", nowSec() - t0, (double)RECTS * FRAMES, "rect");
+}
+
+// =====================[ Entity shapes ]=====================
+// A full wave (8 ghosts + player) as the old multi-rect version (ghost body
+// + 2 eyes, player base + turret) vs. one SDF instance per entity. Fill is
+// the rasterized quad area at 800x600; SDF quads are padded for the rim.
+static void benchEntityShapes() {
+    printf("[entity shapes, 8 ghosts + player @ 800x600]\n");
+    const int GHOSTS = 8, FRAMES = 200000;
+    const float GW = 0.10f, GH = 0.10f, PW = 0.18f, PH = 0.06f, PY = -0.85f;
+    const float PX_PER_UNIT2 = 400.0f * 300.0f;     // NDC spans 2 units per axis
+    float gx[GHOSTS], gy[GHOSTS];
+    for (int i = 0; i < GHOSTS; ++i) { gx[i] = -0.7f + 0.2f * i; gy[i] = 0.6f - 0.05f * (i % 3); }
+
+    RectBatch batch;
+    batch.reserve(64);
+    auto multiRect = [&]() {
+        batch.clear();
+        batch.push(0.0f, PY, PW, PH, 0.1f, 0.9f, 0.9f, 1.0f);
+        batch.push(0.0f, PY + PH * 0.35f, PW * 0.35f, PH * 0.6f, 0.1f, 0.9f, 0.9f, 1.0f);
+        for (int i = 0; i < GHOSTS; ++i) {
+            batch.push(gx[i], gy[i], GW, GH, 0.9f, 0.1f, 0.95f, 1.0f);
+            batch.push(gx[i] - GW * 0.18f, gy[i] + GH * 0.1f, GW * 0.14f, GH * 0.14f, 1, 1, 1, 1);
+            batch.push(gx[i] + GW * 0.18f, gy[i] + GH * 0.1f, GW * 0.14f, GH * 0.14f, 1, 1, 1, 1);
+        }
+    };
+    auto sdf = [&]() {
+        batch.clear();
+        batch.pushShape(SHAPE_PLAYER, 0.0f, PY + PH * 0.075f, PW, PH * 1.15f, 0.1f, 0.9f, 0.9f, 1.0f);
+        for (int i = 0; i < GHOSTS; ++i)
+            batch.pushShape(SHAPE_GHOST, gx[i], gy[i], GW, GH, 0.9f, 0.1f, 0.95f, 1.0f);
+    };
+    auto fill = [&]() {
+        double px = 0.0;
+        for (const RectInstance& r : batch.rects) {
+            float pad = glm::unpackHalf2x16(r.glowShape).y != SHAPE_RECT ? RECT_SHAPE_PAD : 1.0f;
+            px += r.w * pad * r.h * pad * PX_PER_UNIT2;
+        }
+        return px;
+    };
+
+    const char* names[2] = { "multi-rect (before)", "SDF, one quad each (after)" };
+    for (int v = 0; v < 2; ++v) {
+        double t0 = nowSec();
+        for (int f = 0; f < FRAMES; ++f) {
+            if (v == 0) multiRect(); else sdf();
+            g_sink = batch.rects[f % batch.rects.size()].x;
+        }
+        double t = nowSec() - t0;
+        printf("  %-44s %4zu inst %7.0f px %5zu B  %6.1f ns/frame\n", names[v], batch.size(), fill(),
+               batch.size() * sizeof(RectInstance), t * 1e9 / FRAMES);
+    }
+}
+
+// =====================[ Instance packing ]=====================
+// 128k rects per frame: the old all-float instance (56 B) vs. the packed
+// one (32 B: float center/size, unorm color, cached half/unorm rest). "upload" is a memcpy into a staging buffer, the
+// CPU side of glBufferSubData; the bus transfer scales with the same bytes.
+struct RectInstanceF32 {
+    float x, y, w, h, r, g, b, a, glow, u0, v0, u1, v1, shape;
+};
+
+static void benchInstancePacking() {
+    printf("[instance packing, 128k rects]\n");
+    const int N = 128 * 1024, FRAMES = 200;
+    std::vector<float> px(N), py(N), sz(N), col(N);
+    for (int i = 0; i < N; ++i) {
+        px[i] = (i % 512) / 256.0f - 1.0f;
+        py[i] = (i / 512) / 128.0f - 1.0f;
+        sz[i] = 0.004f + (i % 7) * 0.002f;
+        col[i] = (i % 13) / 13.0f;
+    }
+    Sprite flat = { 0.5f, 0.5f, 0.5f, 0.5f, 8, 8 };
+    std::vector<RectInstanceF32> wide;
+    wide.reserve(N);
+    std::vector<unsigned char> staging(N * sizeof(RectInstanceF32));
+
+    double fill = 0.0, copy = 0.0;
+    for (int f = 0; f < FRAMES; ++f) {
+        double t0 = nowSec();
+        wide.clear();
+        for (int i = 0; i < N; ++i)
+            wide.push_back(RectInstanceF32{ px[i], py[i], sz[i], sz[i], col[i], 0.8f, 0.2f, 1.0f, 1.1f,
+                                            flat.u0, flat.v0, flat.u1, flat.v1, 0.0f });
+        double t1 = nowSec();
+        memcpy(staging.data(), wide.data(), wide.size() * sizeof(RectInstanceF32));
+        copy += nowSec() - t1;
+        fill += t1 - t0;
+        g_sink = ((float*)staging.data())[f % N];
+    }
+    double wideBytes = (double)N * sizeof(RectInstanceF32);
+    double wideTotal = (fill + copy) * 1e3 / FRAMES;
+    printf("  %-26s %3zu B/inst %6.2f MB/frame  fill %6.3f ms  upload %6.3f ms  frame %6.3f ms\n", "float32 (before)",
+           sizeof(RectInstanceF32), wideBytes / 1048576.0, fill * 1e3 / FRAMES, copy * 1e3 / FRAMES, wideTotal);
+
+    RectBatch batch;
+    batch.flat = flat;
+    batch.reserve(N);
+    fill = copy = 0.0;
+    for (int f = 0; f < FRAMES; ++f) {
+        double t0 = nowSec();
+        batch.clear();
+        for (int i = 0; i < N; ++i)
+            batch.push(px[i], py[i], sz[i], sz[i], col[i], 0.8f, 0.2f, 1.0f, 1.1f);
+        double t1 = nowSec();
+        memcpy(staging.data(), batch.rects.data(), batch.size() * sizeof(RectInstance));
+        copy += nowSec() - t1;
+        fill += t1 - t0;
+        g_sink = ((float*)staging.data())[f % N];
+    }
+    double packedBytes = (double)N * sizeof(RectInstance);
+    double packedTotal = (fill + copy) * 1e3 / FRAMES;
+    printf("  %-26s %3zu B/inst %6.2f MB/frame  fill %6.3f ms  upload %6.3f ms  frame %6.3f ms\n", "packed (after)",
+           sizeof(RectInstance), packedBytes / 1048576.0, fill * 1e3 / FRAMES, copy * 1e3 / FRAMES, packedTotal);
+    printf("  CPU frame cost (fill + upload): %.3f -> %.3f ms (%+.0f%%)\n", wideTotal, packedTotal,
+           100.0 * (packedTotal - wideTotal) / wideTotal);
+    printf("  bus traffic at 60 fps: %.0f -> %.0f MB/s\n", wideBytes * 60 / 1048576.0, packedBytes * 60 / 1048576.0);
+}
+
+// =====================[ Asset cold start ]=====================
+// Loose files decoded with stb_image vs. the pre-decoded .pak mapped and
+// touched page by page (what the GL upload would read). Page cache is
+// dropped for the files before each run where the OS allows it.
+static void dropFromCache(const char* path) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+static void benchAssetLoading() {
+    printf("[asset cold start]\n");
+    const char* files[] = { "resources/awesomeface.png", "resources/container.jpg" };
+    const int RUNS = 10;
+    stbi_set_flip_vertically_on_load(true);
+
+    std::vector<PackSource> sources;
+    for (const char* f : files) {
+        int w, h, n;
+        unsigned char* px = stbi_load(f, &w, &h, &n, 4);
+        if (!px) { printf("  missing %s (run from the repo root)\n", f); return; }
+        PackSource src{ f, PACK_RGBA8, (uint32_t)w, (uint32_t)h,
+                        std::vector<unsigned char>(px, px + (size_t)w * h * 4) };
+        sources.push_back(src);
+        stbi_image_free(px);
+    }
+    const char* pakPath = "build/bench_assets.pak";
+    if (!writeAssetPack(pakPath, sources)) { printf("  cannot write %s\n", pakPath); return; }
+
+    double loose = 0, packed = 0;
+    unsigned sum = 0;
+    for (int r = 0; r < RUNS; ++r) {
+        for (const char* f : files) dropFromCache(f);
+        double t0 = nowSec();
+        for (const char* f : files) {
+            int w, h, n;
+            unsigned char* px = stbi_load(f, &w, &h, &n, 4);
+            sum += px[0];
+            stbi_image_free(px);
+        }
+        loose += nowSec() - t0;
+
+        dropFromCache(pakPath);
+        t0 = nowSec();
+        AssetPack pack;
+        pack.open(pakPath);
+        for (const char* f : files) {
+            const PackEntry* e = pack.find(f);
+            const unsigned char* px = pack.data(*e);
+            for (uint64_t i = 0; i < e->size; i += 4096) sum += px[i];
+        }
+        packed += nowSec() - t0;
+    }
+    g_sink = (float)sum;
+    printf("  %-44s %10.3f ms\n", "loose files + stbi_load (before)", loose * 1e3 / RUNS);
+    printf("  %-44s %10.3f ms\n", "mapped .pak, pages touched (after)", packed * 1e3 / RUNS);
+    remove(pakPath);
+}
+
+// =====================[ Entity iteration ]=====================
+// Particle update + expiry, and a ghost move pass with half the wave dead:
+// the pre-ECS layout (AoS vectors, alive flags, remove_if) vs archetypes.
+struct LegacyParticle { glm::vec2 pos, vel; float life, size; };
+struct LegacyGhost { float x, y, vx; bool alive; float phase; };
+struct BenchGhostMotion { float vx, phase; };
+
+static void benchEntityIteration() {
+    printf("[entity iteration]\n");
+    const int N = 100000, FRAMES = 200;
+    const float dt = 1.0f / 60.0f;
+
+    // lifetimes staggered so a steady trickle expires every frame
+    std::vector<LegacyParticle> legacy(N);
+    for (int i = 0; i < N; ++i)
+        legacy[i] = LegacyParticle{ glm::vec2(0.0f), glm::vec2(0.3f, -0.2f), 1.0f + (i % 997) * 0.01f, 0.02f };
+    double t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        for (auto& p : legacy) {
+            p.life -= dt * 1.4f;
+            p.pos += p.vel * dt;
+            p.vel *= (1.0f - 0.9f * dt);
+        }
+        legacy.erase(std::remove_if(legacy.begin(), legacy.end(),
+            [](const LegacyParticle& p){ return p.life <= 0.0f; }), legacy.end());
+    }
+    double legacyT = nowSec() - t0;
+
+    typedef Archetype<N, Position, Velocity, ParticleLife> BigParticles;
+    BigParticles* particles = new BigParticles();
+    for (int i = 0; i < N; ++i) {
+        int e = particles->spawn();
+        particles->get<Position>(e) = Position{ 0.0f, 0.0f };
+        particles->get<Velocity>(e) = Velocity{ 0.3f, -0.2f };
+        particles->get<ParticleLife>(e) = ParticleLife{ 1.0f + (i % 997) * 0.01f, 0.02f };
+    }
+    particles->flush();
+    t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        particles->eachIndexed<Position, Velocity, ParticleLife>(
+            [&](uint32_t i, Position& p, Velocity& v, ParticleLife& l) {
+                l.life -= dt * 1.4f;
+                p.x += v.x * dt;
+                p.y += v.y * dt;
+                float drag = 1.0f - 0.9f * dt;
+                v.x *= drag;
+                v.y *= drag;
+                if (l.life <= 0.0f) particles->destroy(i);
+            });
+        particles->flush();
+    }
+    double ecsT = nowSec() - t0;
+    printf("  particles: %zu vs %u left after %d frames\n", legacy.size(), particles->size(), FRAMES);
+    report("particles, AoS vector + remove_if (before)", legacyT, (double)N * FRAMES, "entity");
+    report("particles, archetype SoA (after)", ecsT, (double)N * FRAMES, "entity");
+    delete particles;
+
+    std::vector<LegacyGhost> ghosts(N);
+    for (int i = 0; i < N; ++i)
+        ghosts[i] = LegacyGhost{ 0.0f, 0.5f, 0.4f, (i & 1) == 0, i * 0.1f };
+    float now = 0.0f;
+    t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f, now += dt) {
+        for (auto& g : ghosts) {
+            if (!g.alive) continue;
+            g.x += g.vx * dt + sinf(now * 2.0f + g.phase) * 0.12f * dt;
+            if (g.x > 0.95f || g.x < -0.95f) { g.vx = -g.vx; g.y -= 0.04f; }
+        }
+    }
+    legacyT = nowSec() - t0;
+
+    typedef Archetype<N, Position, BenchGhostMotion> BigGhosts;
+    BigGhosts* dense = new BigGhosts();
+    for (int i = 0; i < N / 2; ++i) {
+        int e = dense->spawn();
+        dense->get<Position>(e) = Position{ 0.0f, 0.5f };
+        dense->get<BenchGhostMotion>(e) = BenchGhostMotion{ 0.4f, i * 0.2f };
+    }
+    dense->flush();
+    now = 0.0f;
+    t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f, now += dt) {
+        dense->each<Position, BenchGhostMotion>([&](Position& g, BenchGhostMotion& m) {
+            g.x += m.vx * dt + sinf(now * 2.0f + m.phase) * 0.12f * dt;
+            if (g.x > 0.95f || g.x < -0.95f) { m.vx = -m.vx; g.y -= 0.04f; }
+        });
+    }
+    ecsT = nowSec() - t0;
+    report("ghosts, half dead, alive flags (before)", legacyT, (double)(N / 2) * FRAMES, "live ghost");
+    report("ghosts, dense archetype (after)", ecsT, (double)(N / 2) * FRAMES, "live ghost");
+    delete dense;
+}
+
+// =====================[ Ghost waves, high kill rate ]=====================
+// 10k-ghost waves where ~8% of the live wave dies each frame (picked by
+// handle, as targeting/scoring would) until the wave is gone, then a new
+// wave spawns. Alive-flag vectors keep visiting the dead until the wave
+// is cleared; the dense pool swap-removes them on the spot.
+static void benchGhostWaves() {
+    printf("[ghost waves, 10k, high kill rate]\n");
+    const int N = 10000, FRAMES = 2000;
+    const float dt = 1.0f / 60.0f;
+    uint32_t rng = 12345;
+    auto next = [&rng]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+
+    std::vector<LegacyGhost> legacy;
+    int waves = 0;
+    uint64_t visited = 0;
+    double t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        int alive = 0;
+        for (auto& g : legacy) {
+            visited++;
+            if (!g.alive) continue;
+            alive++;
+            g.x += g.vx * dt;
+            if (g.x > 0.95f || g.x < -0.95f) { g.vx = -g.vx; g.y -= 0.04f; }
+            if (next() % 100 < 8) g.alive = false;
+        }
+        if (alive == 0) {
+            legacy.clear();
+            for (int i = 0; i < N; ++i) legacy.push_back(LegacyGhost{ 0.0f, 0.5f, 0.4f, true, 0.0f });
+            waves++;
+        }
+    }
+    double legacyT = nowSec() - t0;
+    printf("  alive flags: %d waves, %.1f ghosts visited per frame\n", waves, (double)visited / FRAMES);
+    report("alive flags + clear per wave (before)", legacyT, FRAMES, "frame");
+
+    typedef Archetype<N, Position, BenchGhostMotion> BigGhosts;
+    BigGhosts* pool = new BigGhosts();
+    std::vector<EntityHandle> doomed;
+    doomed.reserve(N);
+    rng = 12345;
+    waves = 0;
+    visited = 0;
+    t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        doomed.clear();
+        pool->eachIndexed<Position, BenchGhostMotion>([&](uint32_t i, Position& g, BenchGhostMotion& m) {
+            visited++;
+            g.x += m.vx * dt;
+            if (g.x > 0.95f || g.x < -0.95f) { m.vx = -m.vx; g.y -= 0.04f; }
+            if (next() % 100 < 8) doomed.push_back(pool->handle(i));
+        });
+        // kills arrive later by handle, the way a scorer or targeter would issue them
+        for (const EntityHandle& h : doomed) pool->destroy(h);
+        pool->flush();
+        if (pool->size() == 0) {
+            for (int i = 0; i < N; ++i) {
+                int e = pool->spawn();
+                pool->get<Position>(e) = Position{ 0.0f, 0.5f };
+                pool->get<BenchGhostMotion>(e) = BenchGhostMotion{ 0.4f, 0.0f };
+            }
+            pool->flush();
+            waves++;
+        }
+    }
+    double denseT = nowSec() - t0;
+    printf("  dense pool:  %d waves, %.1f ghosts visited per frame\n", waves, (double)visited / FRAMES);
+    report("dense pool + handles (after)", denseT, FRAMES, "frame");
+    delete pool;
+}
+
+// =====================[ Ghost movement kernel ]=====================
+// 100k ghosts: the original per-ghost loop (libm sin, branchy bounce and
+// line check) vs. the SoA kernel writing event bitmasks.
+static void benchGhostKernel() {
+    printf("[ghost kernel, 100k]\n");
+    const uint32_t N = 100000;
+    const int FRAMES = 300;
+    const float dt = 1.0f / 60.0f;
+    std::vector<float> x(N), y(N), vx(N), phase(N);
+    auto seed = [&]() {
+        for (uint32_t i = 0; i < N; ++i) {
+            x[i] = -0.9f + 1.8f * (float)(i % 1000) / 1000.0f;
+            y[i] = 0.2f + 0.7f * (float)(i % 777) / 777.0f;
+            vx[i] = (i & 1) ? 0.5f : -0.5f;
+            phase[i] = (float)(i % 628) * 0.01f;
+        }
+    };
+    GhostKernelParams kp = { dt, 0.0f, 0.05f, 0.04f, -0.76f, 1, 0.1f, 0.5f, 0.06f, 0.08f };
+
+    seed();
+    uint32_t events = 0;
+    double t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        float now = f * dt;
+        for (uint32_t i = 0; i < N; ++i) {
+            x[i] += vx[i] * dt;
+            x[i] += sinf(now * 2.0f + phase[i]) * 0.12f * dt;
+            if (x[i] + kp.halfW > 1.0f) { x[i] = 1.0f - kp.halfW; vx[i] = -std::fabs(vx[i]); y[i] -= kp.drop; }
+            else if (x[i] - kp.halfW < -1.0f) { x[i] = -1.0f + kp.halfW; vx[i] = std::fabs(vx[i]); y[i] -= kp.drop; }
+            if (y[i] <= kp.lineY) events++;
+            if (std::fabs(kp.bulletX - x[i]) < kp.hitX && std::fabs(kp.bulletY - y[i]) < kp.hitY) events++;
+        }
+    }
+    double scalarT = nowSec() - t0;
+    g_sink = (float)events;
+
+    seed();
+    std::vector<uint32_t> lineMask(ghostMaskWords(N)), hitMask(ghostMaskWords(N));
+    uint32_t kernelEvents = 0;
+    t0 = nowSec();
+    for (int f = 0; f < FRAMES; ++f) {
+        kp.time = f * dt;
+        if (ghostKernel(x.data(), y.data(), vx.data(), phase.data(), N, kp, lineMask.data(), hitMask.data()))
+            for (uint32_t w = 0; w < ghostMaskWords(N); ++w)
+                kernelEvents += __builtin_popcount(lineMask[w]) + __builtin_popcount(hitMask[w]);
+    }
+    double kernelT = nowSec() - t0;
+    printf("  events: %u scalar vs %u kernel\n", events, kernelEvents);
+
+    // the SIMD lanes and ghostStep1 (non-SSE2 builds, the tail) must agree
+    // to the bit, or peers built differently desync
+    std::vector<float> sx(N), sy(N), svx(N);
+    seed();
+    sx = x; sy = y; svx = vx;
+    uint32_t maskMismatches = 0;
+    for (int f = 0; f < FRAMES; ++f) {
+        kp.time = f * dt;
+        ghostKernel(x.data(), y.data(), vx.data(), phase.data(), N, kp, lineMask.data(), hitMask.data());
+        for (uint32_t i = 0; i < N; ++i) {
+            bool reached, hit;
+            ghostStep1(sx[i], sy[i], svx[i], phase[i], kp, reached, hit);
+            maskMismatches += reached != ((lineMask[i >> 5] >> (i & 31)) & 1);
+            maskMismatches += hit != ((hitMask[i >> 5] >> (i & 31)) & 1);
+        }
+    }
+    uint32_t stateMismatches = 0;
+    for (uint32_t i = 0; i < N; ++i)
+        stateMismatches += memcmp(&x[i], &sx[i], 4) != 0 || memcmp(&y[i], &sy[i], 4) != 0 ||
+                           memcmp(&vx[i], &svx[i], 4) != 0;
+    printf("  kernel vs ghostStep1: %u ghosts differ, %u event bits differ\n", stateMismatches, maskMismatches);
+    if (stateMismatches || maskMismatches) printf("  GHOST KERNEL REGRESSION: SIMD and scalar paths disagree\n");
+    report("per-ghost loop, libm sin (before)", scalarT, (double)N * FRAMES, "ghost");
+    report("SoA kernel + event bitmasks (after)", kernelT, (double)N * FRAMES, "ghost");
+    printf("  %-44s %10.1f M ghosts/s\n", "kernel throughput", N * (double)FRAMES / kernelT * 1e-6);
+}
+
+// =====================[ Snapshots ]=====================
+// Save/restore of a full GameState with every pool at capacity
+static void benchSnapshots() {
+    printf("[snapshots, %d ghosts + %d particles, %zu bytes]\n", MAX_GHOSTS, MAX_PARTICLES, sizeof(GameState));
+    const int ITERS = 200000;
+    GameState* g = new GameState();
+    gameReset(*g, 2, 1234);
+    simSpawnWave(*g, MAX_GHOSTS);
+    simSpawnExplosion(*g, 0.0f, 0.0f, MAX_PARTICLES);
+    g->world.get<ParticleArchetype>().flush();
+    printf("  live: %u ghosts, %u particles\n", g->world.get<GhostArchetype>().size(),
+           g->world.get<ParticleArchetype>().size());
+
+    typedef SnapshotRing<GameState, 32> Ring;
+    Ring* ring = new Ring();
+    double t0 = nowSec();
+    for (int i = 0; i < ITERS; ++i) {
+        g->tick = (uint32_t)i;
+        ring->save((uint32_t)i, *g);
+    }
+    double saveT = nowSec() - t0;
+
+    uint32_t restored = 0;
+    t0 = nowSec();
+    for (int i = 0; i < ITERS; ++i)
+        restored += ring->restore((uint32_t)(ITERS - 1 - (i & 31)), *g) ? 1 : 0;
+    double restoreT = nowSec() - t0;
+    g_sink = (float)(restored + g->tick);
+
+    report("save (memcpy into ring)", saveT, ITERS, "snapshot");
+    report("restore (memcpy out of ring)", restoreT, ITERS, "snapshot");
+    printf("  %-44s %10.2f GB/s\n", "save bandwidth", (double)sizeof(GameState) * ITERS / saveT * 1e-9);
+    delete ring;
+    delete g;
+}
+
+// =====================[ Snapshot codec ]=====================
+static bool sameQuantized(const QuantizedState& a, const QuantizedState& b) {
+    if (a.tick != b.tick || a.numPlayers != b.numPlayers || a.lives != b.lives || a.gameOver != b.gameOver ||
+        a.ghostCount != b.ghostCount || a.particleCount != b.particleCount)
+        return false;
+    return memcmp(a.players, b.players, sizeof(a.players)) == 0 &&
+           memcmp(a.ghosts, b.ghosts, a.ghostCount * sizeof(a.ghosts[0])) == 0 &&
+           memcmp(a.particles, b.particles, a.particleCount * sizeof(a.particles[0])) == 0;
+}
+
+// Random play (explosion bursts added when `busy`), each tick delta coded
+// against the previous one, a keyframe once a second
+static void benchSnapshotCodecRun(const char* name, bool busy, int positionBits) {
+    const int TICKS = 3600;
+    GameState* g = new GameState();
+    gameReset(*g, 2, 2024);
+    SnapshotCodec codec;
+    codec.config.positionBits = positionBits;
+    QuantizedState* q = new QuantizedState[3];     // current, baseline, decoded
+    BitWriter out;
+    uint32_t rng = 5;
+    auto next = [&rng]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+
+    size_t deltaBytes = 0, keyBytes = 0, keys = 0, particles = 0;
+    double encT = 0.0, decT = 0.0;
+    bool ok = true;
+    for (int t = 0; t < TICKS; ++t) {
+        PlayerInput in[MAX_PLAYERS] = { (PlayerInput)(next() & 15), (PlayerInput)(next() & 15) };
+        simStep(*g, in);
+        if (busy && t % 20 == 0) {
+            simSpawnExplosion(*g, (float)(next() % 100) / 60.0f - 0.8f, 0.3f, 300);
+            g->world.flush();
+        }
+        particles += g->world.get<ParticleArchetype>().size();
+        bool key = t % 60 == 0;
+
+        double t0 = nowSec();
+        codec.quantize(*g, q[0]);
+        codec.encode(q[0], key ? nullptr : &q[1], out);
+        encT += nowSec() - t0;
+        (key ? keyBytes : deltaBytes) += out.bytes.size();
+        keys += key ? 1 : 0;
+
+        t0 = nowSec();
+        ok = codec.decode(out.bytes.data(), out.bytes.size(), key ? nullptr : &q[1], q[2]) && ok;
+        decT += nowSec() - t0;
+        ok = ok && sameQuantized(q[0], q[2]);
+        q[1] = q[0];
+    }
+    printf("  %s, %d-bit positions, avg %.0f particles\n", name, positionBits, (double)particles / TICKS);
+    printf("  %-44s %10.1f bytes/tick (%.1f kbit/s at 60 Hz)\n", "delta", (double)deltaBytes / (TICKS - keys),
+           deltaBytes * 8.0 / (TICKS - keys) * 60.0 / 1000.0);
+    printf("  %-44s %10.1f bytes/tick\n", "keyframe", (double)keyBytes / keys);
+    report("quantize + encode", encT, TICKS, "tick");
+    report("decode", decT, TICKS, "tick");
+    printf("  %-44s %6.0fk / %.0fk ticks/s, round trip %s\n", "encode / decode throughput",
+           TICKS / encT * 1e-3, TICKS / decT * 1e-3, ok ? "exact" : "MISMATCH");
+    delete[] q;
+    delete g;
+}
+
+static void benchSnapshotCodec() {
+    printf("[snapshot codec, raw GameState %zu bytes]\n", sizeof(GameState));
+    benchSnapshotCodecRun("random play", false, 12);
+    benchSnapshotCodecRun("explosion bursts", true, 12);
+    benchSnapshotCodecRun("explosion bursts", true, 10);
+}
+
+// =====================[ Rollback ]=====================
+// Two sessions over a lossy loopback, random inputs, virtual clock. Both
+// peers must end on the same state once all inputs have been exchanged.
+struct RollbackScenario {
+    const char* name;
+    double latencyMs, jitterMs, lossPercent;
+    int    maxRollback;
+    int    lateStart;           // frames peer 1 starts after peer 0
+    bool   verbose;
+};
+
+// Two peers over a simulated network for TICKS frames, then drained to
+// the same tick. Fails when the session stopped advancing (a stall that
+// never resolves) or the peers end with different states.
+static bool runRollbackScenario(const RollbackScenario& sc) {
+    const int TICKS = 6000;
+    const double TICK_MS = 1000.0 / 60.0;
+    LoopbackNetwork net(777);
+    net.latencyMs = sc.latencyMs;
+    net.jitterMs = sc.jitterMs;
+    net.lossPercent = sc.lossPercent;
+    RollbackSession* peers = new RollbackSession[2];
+    for (int p = 0; p < 2; ++p) {
+        peers[p].maxRollback = sc.maxRollback;
+        peers[p].start(p, net.endpoint(p), 4242);
+    }
+    uint32_t rng = 99;
+    auto next = [&rng]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+    PlayerInput held[2] = { 0, 0 };
+
+    double t0 = nowSec();
+    for (int f = 0; f < TICKS; ++f) {
+        net.setTime(f * TICK_MS);
+        for (int p = 0; p < 2; ++p) {
+            if (p == 1 && f < sc.lateStart) continue;
+            if (next() % 8 == 0) held[p] = (PlayerInput)(next() & (INPUT_LEFT | INPUT_RIGHT | INPUT_FIRE | INPUT_RESTART));
+            peers[p].advance(held[p]);
+        }
+    }
+    double runT = nowSec() - t0;
+
+    // bring the one behind up to the other, then let the network drain
+    uint32_t target = std::max(peers[0].tick(), peers[1].tick());
+    double clock = TICKS * TICK_MS;
+    for (int guard = 0; guard < 100000; ++guard) {
+        bool done = true;
+        for (int p = 0; p < 2; ++p) {
+            if (peers[p].tick() < target) { peers[p].advance(held[p]); done = false; }
+            else peers[p].poll();
+            if (peers[p].confirmedTick() < target) done = false;
+        }
+        if (done) break;
+        clock += TICK_MS;
+        net.setTime(clock);
+    }
+    // a healthy session keeps up with real time minus the late start and
+    // a few round trips of stalling
+    bool advanced = std::min(peers[0].tick(), peers[1].tick()) > (uint32_t)(TICKS - sc.lateStart) / 2;
+    bool match = peers[0].tick() == peers[1].tick() &&
+                 gameChecksum(peers[0].presented()) == gameChecksum(peers[1].presented());
+
+    const RollbackStats& s = peers[0].stats;
+    if (sc.verbose) {
+        printf("  packets: %llu sent, %llu dropped\n", (unsigned long long)net.sent, (unsigned long long)net.dropped);
+        printf("  peer 0: %llu ticks, %llu rollbacks (max depth %d), %llu stalls\n",
+               (unsigned long long)s.ticks, (unsigned long long)s.rollbacks, s.maxDepth, (unsigned long long)s.stalls);
+        printf("  %-44s %10.1f ticks/ms\n", "re-simulation throughput", s.ticksPerMs());
+        printf("  %-44s %10.2f ns/snapshot (%zu bytes)\n", "snapshot (GameState copy)", s.snapshotNs(), sizeof(GameState));
+        report("whole session, both peers", runT, TICKS, "frame");
+    }
+    printf("  %-30s final tick %5u of %d, %6llu stalls, checksums %s%s\n", sc.name, peers[0].tick(), TICKS,
+           (unsigned long long)s.stalls, match ? "match" : "DIFFER", advanced ? "" : "  STALLED");
+    delete[] peers;
+    return advanced && match;
+}
+
+static void benchRollback() {
+    printf("[rollback, 2 peers]\n");
+    const RollbackScenario scenarios[] = {
+        { "100 ms +-10 ms, 5% loss",     100.0, 10.0,  5.0, 16,   0, true  },
+        { "no latency",                    0.0,  0.0,  0.0,  8,   0, false },
+        { "peer 1 starts 1.5 s late",     30.0,  5.0,  0.0,  8,  90, false },
+        { "100 ms, 30% loss, window 8",  100.0, 10.0, 30.0,  8,   0, false },
+        { "100 ms, 60% loss, window 16", 100.0, 10.0, 60.0, 16,   0, false },
+        { "window 31, 20% loss",          80.0, 20.0, 20.0, 31,  45, false },
+    };
+    int failed = 0;
+    for (const RollbackScenario& sc : scenarios) failed += runRollbackScenario(sc) ? 0 : 1;
+    if (failed) printf("  ROLLBACK REGRESSION: %d scenario(s) failed\n", failed);
+}
+
+// =====================[ Batched environment ]=====================
+// Env steps per second on one core: BatchEnv (SoA across instances)
+// against one GameState + simStep per instance
+static void benchBatchEnv() {
+    const int N = 4096, STEPS = 1000;
+    printf("[batched env, %d instances, random actions]\n", N);
+    std::vector<PlayerInput> actions(N);
+    std::vector<float> rewards(N), obs((size_t)N * BATCH_OBS_SIZE);
+    std::vector<uint8_t> dones(N);
+    std::vector<uint32_t> seeds(N);
+    uint32_t rng = 31;
+    auto next = [&rng]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+    for (int i = 0; i < N; ++i) seeds[i] = next();
+    // actions are drawn up front so the timed loops only step games
+    std::vector<PlayerInput> script((size_t)STEPS * 8);
+    for (auto& a : script) a = (PlayerInput)(next() & (INPUT_LEFT | INPUT_RIGHT | INPUT_FIRE));
+    auto fillActions = [&](int step) {
+        for (int i = 0; i < N; ++i) actions[i] = script[((size_t)step * 8 + (i & 7)) % script.size()];
+    };
+
+    const int AOS_N = 512;
+    std::vector<GameState> games(AOS_N);
+    for (int i = 0; i < AOS_N; ++i) gameReset(games[i], 1, seeds[i]);
+    double t0 = nowSec();
+    for (int s = 0; s < STEPS; ++s) {
+        fillActions(s);
+        for (int i = 0; i < AOS_N; ++i) {
+            PlayerInput in[MAX_PLAYERS] = { actions[i], 0 };
+            simStep(games[i], in);
+            if (games[i].gameOver) gameReset(games[i], 1, seeds[i] + s);
+        }
+    }
+    double aosT = nowSec() - t0;
+
+    // a lane must replay simStep: no firing (kills part the RNG streams, see
+    // batch_env.h), random moves, until the GameState's game is over
+    const int PARITY_N = 16, PARITY_TICKS = 20000;
+    BatchEnv* lanes = new BatchEnv();
+    lanes->maxEpisodeTicks = PARITY_TICKS + 1;
+    lanes->init(PARITY_N, seeds.data());
+    std::vector<GameState> mirror(PARITY_N);
+    for (int i = 0; i < PARITY_N; ++i) gameReset(mirror[i], 1, seeds[i]);
+    int parityTicks = 0, parityDiverged = 0;
+    std::vector<uint8_t> diverged(PARITY_N);
+    for (int s = 0; s < PARITY_TICKS; ++s) {
+        for (int i = 0; i < PARITY_N; ++i) actions[i] = (PlayerInput)(next() & (INPUT_LEFT | INPUT_RIGHT));
+        lanes->step(actions.data(), rewards.data(), dones.data());
+        bool running = false;
+        for (int i = 0; i < PARITY_N; ++i) {
+            if (mirror[i].gameOver) continue;
+            PlayerInput in[MAX_PLAYERS] = { actions[i], 0 };
+            simStep(mirror[i], in);
+            if (mirror[i].gameOver) continue;   // the lane has already reset
+            running = true;
+            parityTicks++;
+            if (!diverged[i] && lanes->checksum(i) != batchChecksum(mirror[i])) {
+                diverged[i] = 1;
+                parityDiverged++;
+            }
+        }
+        if (!running) break;
+    }
+    delete lanes;
+    printf("  BatchEnv vs simStep: %d of %d lanes diverged over %d lane ticks\n",
+           parityDiverged, PARITY_N, parityTicks);
+
+    // episodes truncated at 5 s so a 1000-step run sees several resets
+    BatchEnv* env = new BatchEnv();
+    env->maxEpisodeTicks = 300;
+    env->init(N, seeds.data());
+    // different seeds must give different starting waves
+    env->observe(obs.data());
+    int sameObs = 0;
+    for (int i = 1; i < N; ++i)
+        sameObs += memcmp(&obs[(size_t)i * BATCH_OBS_SIZE], &obs[(size_t)(i - 1) * BATCH_OBS_SIZE],
+                          BATCH_OBS_SIZE * sizeof(float)) == 0;
+    uint64_t doneCount = 0;
+    double stepT = 0.0, obsT = 0.0, rewardSum = 0.0;
+    for (int s = 0; s < STEPS; ++s) {
+        fillActions(s);
+        t0 = nowSec();
+        env->step(actions.data(), rewards.data(), dones.data());
+        double t1 = nowSec();
+        env->observe(obs.data());
+        obsT += nowSec() - t1;
+        stepT += t1 - t0;
+        for (int i = 0; i < N; ++i) {
+            rewardSum += rewards[i];
+            doneCount += dones[i];
+        }
+    }
+    g_sink = obs[0];
+    printf("  %llu episodes finished (%llu dones), mean reward/step %.4f, obs %d floats\n",
+           (unsigned long long)env->episodes, (unsigned long long)doneCount,
+           rewardSum / ((double)N * STEPS), BATCH_OBS_SIZE);
+    if (doneCount == 0 || env->episodes != doneCount || sameObs || parityDiverged)
+        printf("  BATCH ENV REGRESSION: %llu dones, %llu episodes, %d seed pairs with equal observations, "
+               "%d lanes off simStep\n",
+               (unsigned long long)doneCount, (unsigned long long)env->episodes, sameObs, parityDiverged);
+    report("GameState + simStep per instance (before)", aosT, (double)AOS_N * STEPS, "env step");
+    report("BatchEnv step (after)", stepT, (double)N * STEPS, "env step");
+    report("BatchEnv observation tensor", obsT, (double)N * STEPS, "env step");
+    printf("  %-44s %10.1f M env steps/s/core\n", "throughput incl. observations",
+           (double)N * STEPS / (stepT + obsT) * 1e-6);
+    delete env;
+}
+
+static void benchAudioMixer() {
+    const int BUFFERS = 20000;
+    printf("[audio mixer, %d-frame buffers at %d Hz, offline]\n", AUDIO_BLOCK, AUDIO_RATE);
+    NullAudioBackend out;
+    AudioMixer* mixer = new AudioMixer();
+    mixer->init(&out);
+    const int voiceCounts[] = { 1, 8, AUDIO_MAX_VOICES };
+    for (int voices : voiceCounts) {
+        double t0 = nowSec();
+        for (int b = 0; b < BUFFERS; ++b) {
+            // exactly `voices` sounds going: the longest clip, restarted
+            // before it ends
+            if (b % 100 == 0) {
+                mixer->stopAll();
+                for (int v = 0; v < voices; ++v) mixer->play(SOUND_LIFE_LOST, 0.5f, (v % 5) * 0.5f - 1.0f);
+            }
+            mixer->mixBlock();
+        }
+        double t = nowSec() - t0;
+        char label[64];
+        snprintf(label, sizeof(label), "mix + int16 pack, %d voices", voices);
+        report(label, t, BUFFERS, "buffer");
+        printf("  %-44s %10.3f %% of the buffer period\n", "",
+               100.0 * t / BUFFERS / ((double)AUDIO_BLOCK / AUDIO_RATE));
+    }
+    delete mixer;
+}
+
+int main()
+{
+    printf("Ghost Busters benchmarks\n");
+    benchRectTransform();
+    benchEntityShapes();
+    benchInstancePacking();
+    benchAssetLoading();
+    benchEntityIteration();
+    benchGhostWaves();
+    benchGhostKernel();
+    benchSnapshots();
+    benchRollback();
+    benchSnapshotCodec();
+    benchBatchEnv();
+    benchAudioMixer();
+    return 0;
+}
@@ -13,62 +13,43 @@ class Shader
 {
 public:
     unsigned int ID;
+    std::string vertexPath;
+    std::string fragmentPath;
     // constructor generates the shader on the fly
     // ------------------------------------------------------------------------
     Shader(const char* vertexPath, const char* fragmentPath)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath)
     {
-        // 1. retrieve the vertex/fragment source code from filePath
-        std::string vertexCode;
-        std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
-        // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        try 
-        {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
-            // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();		
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode = vShaderStream.str();
-            fragmentCode = fShaderStream.str();			
-        }
-        catch (std::ifstream::failure& e)
+        bool ok;
+        ID = build(ok, true);
+    }
+    // optional lookup for sources baked into an archive (the asset pack);
+    // returns false for paths it does not have, which are read from disk
+    // ------------------------------------------------------------------------
+    typedef bool (*SourceLookup)(const std::string& path, std::string& source);
+    static SourceLookup& packedSources()
+    {
+        static SourceLookup lookup = nullptr;
+        return lookup;
+    }
+    // recompile from the same files (always from disk, the archive is what
+    // was baked); on failure the old program stays in use.
+    // uniform values and uniform block bindings are carried over by name.
+    // ------------------------------------------------------------------------
+    bool reload()
+    {
+        bool ok;
+        unsigned int fresh = build(ok, false);
+        if (!ok)
         {
-            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+            glDeleteProgram(fresh);
+            std::cout << "SHADER::RELOAD_FAILED keeping previous program: " << vertexPath << " / " << fragmentPath << std::endl;
+            return false;
         }
-        const char* vShaderCode = vertexCode.c_str();
-        const char * fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
-        unsigned int vertex, fragment;
-        // vertex shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-        // fragment Shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
-        // shader Program
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-        // delete the shaders as they're linked into our program now and no longer necessary
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-
+        transferState(ID, fresh);
+        glDeleteProgram(ID);
+        ID = fresh;
+        return true;
     }
     // activate the shader
     // ------------------------------------------------------------------------
@@ -136,9 +117,135 @@ public:
     }
 
 private:
+    // read both sources, compile and link; ok is false on any error
+    // ------------------------------------------------------------------------
+    unsigned int build(bool& ok, bool allowPacked)
+    {
+        // 1. retrieve the vertex/fragment source code from the archive or filePath
+        std::string vertexCode;
+        std::string fragmentCode;
+        SourceLookup lookup = allowPacked ? packedSources() : nullptr;
+        if (lookup && lookup(vertexPath, vertexCode) && lookup(fragmentPath, fragmentCode))
+        {
+            ok = true;
+            return compile(ok, vertexCode, fragmentCode);
+        }
+        std::ifstream vShaderFile;
+        std::ifstream fShaderFile;
+        // ensure ifstream objects can throw exceptions:
+        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+        ok = true;
+        try 
+        {
+            // open files
+            vShaderFile.open(vertexPath);
+            fShaderFile.open(fragmentPath);
+            std::stringstream vShaderStream, fShaderStream;
+            // read file's buffer contents into streams
+            vShaderStream << vShaderFile.rdbuf();
+            fShaderStream << fShaderFile.rdbuf();
+            // close file handlers
+            vShaderFile.close();
+            fShaderFile.close();
+            // convert stream into string
+            vertexCode = vShaderStream.str();
+            fragmentCode = fShaderStream.str();
+        }
+        catch (std::ifstream::failure& e)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+            ok = false;
+        }
+        return compile(ok, vertexCode, fragmentCode);
+    }
+    // ------------------------------------------------------------------------
+    unsigned int compile(bool& ok, const std::string& vertexCode, const std::string& fragmentCode)
+    {
+        const char* vShaderCode = vertexCode.c_str();
+        const char * fShaderCode = fragmentCode.c_str();
+        // 2. compile shaders
+        unsigned int vertex, fragment;
+        // vertex shader
+        vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, NULL);
+        glCompileShader(vertex);
+        ok &= checkCompileErrors(vertex, "VERTEX");
+        // fragment Shader
+        fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, NULL);
+        glCompileShader(fragment);
+        ok &= checkCompileErrors(fragment, "FRAGMENT");
+        // shader Program
+        unsigned int program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        ok &= checkCompileErrors(program, "PROGRAM");
+        // delete the shaders as they're linked into our program now and no longer necessary
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return program;
+    }
+    // copy default-block uniform values and uniform block bindings from one
+    // program to another, matching by name and type
+    // ------------------------------------------------------------------------
+    static void transferState(GLuint from, GLuint to)
+    {
+        GLint prev;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &prev);
+        glUseProgram(to);
+        GLint count = 0;
+        glGetProgramiv(to, GL_ACTIVE_UNIFORMS, &count);
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLchar name[256];
+            GLint size; GLenum type;
+            glGetActiveUniform(to, (GLuint)i, sizeof(name), NULL, &size, &type, name);
+            GLint dst = glGetUniformLocation(to, name);
+            GLint src = glGetUniformLocation(from, name);
+            if (dst < 0 || src < 0 || size != 1) continue;   // block members, arrays, new uniforms
+            GLint oldSize; GLenum oldType; GLchar oldName[256];
+            bool sameType = false;
+            GLint oldCount = 0;
+            glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &oldCount);
+            for (GLint j = 0; j < oldCount && !sameType; ++j)
+            {
+                glGetActiveUniform(from, (GLuint)j, sizeof(oldName), NULL, &oldSize, &oldType, oldName);
+                sameType = oldType == type && std::string(oldName) == name;
+            }
+            if (!sameType) continue;
+            GLfloat f[16]; GLint v[4];
+            switch (type)
+            {
+            case GL_FLOAT:      glGetUniformfv(from, src, f); glUniform1fv(dst, 1, f); break;
+            case GL_FLOAT_VEC2: glGetUniformfv(from, src, f); glUniform2fv(dst, 1, f); break;
+            case GL_FLOAT_VEC3: glGetUniformfv(from, src, f); glUniform3fv(dst, 1, f); break;
+            case GL_FLOAT_VEC4: glGetUniformfv(from, src, f); glUniform4fv(dst, 1, f); break;
+            case GL_FLOAT_MAT4: glGetUniformfv(from, src, f); glUniformMatrix4fv(dst, 1, GL_FALSE, f); break;
+            case GL_INT:
+            case GL_BOOL:
+            case GL_SAMPLER_2D: glGetUniformiv(from, src, v); glUniform1iv(dst, 1, v); break;
+            default: break;
+            }
+        }
+        GLint blocks = 0;
+        glGetProgramiv(to, GL_ACTIVE_UNIFORM_BLOCKS, &blocks);
+        for (GLint i = 0; i < blocks; ++i)
+        {
+            GLchar name[256];
+            glGetActiveUniformBlockName(to, (GLuint)i, sizeof(name), NULL, name);
+            GLuint oldIndex = glGetUniformBlockIndex(from, name);
+            if (oldIndex == GL_INVALID_INDEX) continue;
+            GLint binding;
+            glGetActiveUniformBlockiv(from, oldIndex, GL_UNIFORM_BLOCK_BINDING, &binding);
+            glUniformBlockBinding(to, (GLuint)i, (GLuint)binding);
+        }
+        glUseProgram((GLuint)prev);
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
-    void checkCompileErrors(GLuint shader, std::string type)
+    bool checkCompileErrors(GLuint shader, std::string type)
     {
         GLint success;
         GLchar infoLog[1024];
@@ -160,6 +267,7 @@ private:
                 std::cout << "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success != 0;
     }
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#version 330 core
+// One direction of a separable Gaussian. weights[0] is the center tap,
+// weights[i] is applied at +-i texels; radius comes from the quality level.
+out vec4 FragColor;
+in vec2 vUV;
+
+uniform sampler2D source;
+uniform vec2  direction;   // texel step: (1/w, 0) or (0, 1/h)
+uniform int   radius;
+uniform float weights[8];
+
+void main() {
+    vec3 c = texture(source, vUV).rgb * weights[0];
+    for (int i = 1; i <= radius; ++i) {
+        c += texture(source, vUV + direction * float(i)).rgb * weights[i];
+        c += texture(source, vUV - direction * float(i)).rgb * weights[i];
+    }
+    FragColor = vec4(c, 1.0);
+}
@@ -0,0 +1,23 @@
+#version 330 core
+// Bright pass + 2x downsample: 4 bilinear taps cover the 4x4 source texels
+// under each half-res pixel, then only what exceeds the threshold is kept
+out vec4 FragColor;
+in vec2 vUV;
+
+uniform sampler2D source;
+uniform vec2  texel;       // 1 / source size
+uniform float threshold;   // 0 = plain downsample
+uniform float knee;        // soft transition width above the threshold
+
+void main() {
+    vec3 c = texture(source, vUV + texel * vec2(-1.0, -1.0)).rgb
+           + texture(source, vUV + texel * vec2( 1.0, -1.0)).rgb
+           + texture(source, vUV + texel * vec2(-1.0,  1.0)).rgb
+           + texture(source, vUV + texel * vec2( 1.0,  1.0)).rgb;
+    c *= 0.25;
+    float bright = max(c.r, max(c.g, c.b));
+    float soft = clamp(bright - threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee + 1e-4);
+    float contrib = max(soft, bright - threshold) / max(bright, 1e-4);
+    FragColor = vec4(c * contrib, 1.0);
+}
@@ -0,0 +1,15 @@
+#version 330 core
+// Scene plus the blurred half and quarter levels, added on top
+out vec4 FragColor;
+in vec2 vUV;
+
+uniform sampler2D scene;
+uniform sampler2D bloomHalf;
+uniform sampler2D bloomQuarter;
+uniform float intensity;
+
+void main() {
+    vec3 c = texture(scene, vUV).rgb;
+    vec3 b = texture(bloomHalf, vUV).rgb + texture(bloomQuarter, vUV).rgb;
+    FragColor = vec4(c + b * intensity, 1.0);
+}
@@ -0,0 +1,9 @@
+#version 330 core
+// Fullscreen triangle from gl_VertexID; no vertex buffers needed
+out vec2 vUV;
+uniform float depth;   // 0 unless drawn inside a depth-tested layer
+void main() {
+    vec2 p = vec2((gl_VertexID == 1) ? 3.0 : -1.0, (gl_VertexID == 2) ? 3.0 : -1.0);
+    vUV = p * 0.5 + 0.5;
+    gl_Position = vec4(p, depth, 1.0);
+}
@@ -0,0 +1,79 @@
+#version 330 core
+// Two modes — atlas-textured/solid color, or vertical gradient.
+// Also supports a "glow" multiplier (for pulsing ghosts/objects)
+// and signed distance shapes (ghost, player blaster) in one quad each.
+// Output is premultiplied alpha; the layer picks the blend function.
+out vec4 FragColor;
+in vec3 vWorldPos;
+in vec4 vColor;
+in float vGlow;            // 1.0 = normal, >1 brighter, <1 dimmer
+in vec2 vUV;
+flat in int vShape;
+in vec2 vLocal;
+flat in vec2 vSize;
+
+uniform sampler2D atlas;   // flat rects sample its white texel
+
+uniform int   useGradient;
+uniform vec3  gradTop;
+uniform vec3  gradBottom;
+uniform float time;        // skirt wave
+
+const vec3 EYE_COLOR = vec3(1.0);
+
+float sdBox(vec2 p, vec2 b) {
+    vec2 d = abs(p) - b;
+    return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0);
+}
+float sdRoundBox(vec2 p, vec2 b, float r) {
+    return sdBox(p, b - r) - r;
+}
+
+// Ghost in units of its height: head circle + torso, skirt cut by a wave
+float sdGhost(vec2 u, out float eyes) {
+    float head = length(u - vec2(0.0, 0.05)) - 0.40;
+    float torso = sdBox(u - vec2(0.0, -0.225), vec2(0.40, 0.275));
+    float wave = 0.05 * sin(u.x * 25.0 + time * 6.0);
+    float body = max(min(head, torso), (-0.42 + wave) - u.y);
+    vec2 e = vec2(abs(u.x) - 0.16, u.y - 0.08);
+    eyes = length(e) - 0.07;
+    return body;
+}
+
+// Blaster: base W x H plus a turret, box is (W, 1.15 H) centered on both
+float sdPlayer(vec2 p, vec2 size) {
+    float H = size.y / 1.15, W = size.x;
+    float base = sdRoundBox(p - vec2(0.0, -0.075 * H), vec2(0.5 * W, 0.5 * H), 0.35 * H);
+    float turret = sdRoundBox(p - vec2(0.0, 0.275 * H), vec2(0.175 * W, 0.3 * H), 0.12 * W);
+    return min(base, turret) / H;   // same units as the ghost
+}
+
+// coverage from a distance, one pixel of antialiasing
+float coverage(float d) {
+    return clamp(0.5 - d / max(fwidth(d), 1e-5), 0.0, 1.0);
+}
+
+void main() {
+    vec3 color;
+    if (useGradient == 1) {
+        // Map NDC y (-1..1) -> 0..1
+        float t = clamp(vWorldPos.y * 0.5 + 0.5, 0.0, 1.0);
+        color = mix(gradBottom, gradTop, t);
+        FragColor = vec4(color, 1.0);
+    } else if (vShape == 0) {
+        vec4 texel = texture(atlas, vUV) * vColor;
+        color = texel.rgb * vGlow;
+        FragColor = vec4(color * texel.a, texel.a);
+    } else {
+        float eyes = 1.0;
+        float d = vShape == 1 ? sdGhost(vLocal / vSize.y, eyes) : sdPlayer(vLocal, vSize);
+        float fill = coverage(d);
+        // brighter just inside the edge, soft glow just outside
+        vec3 body = vColor.rgb * vGlow * (1.0 + 0.6 * smoothstep(-0.08, 0.0, d));
+        body = mix(body, EYE_COLOR, coverage(eyes));
+        float rim = 0.6 * exp(-max(d, 0.0) / 0.05) * (1.0 - fill);
+        color = body * fill + vColor.rgb * vGlow * rim;
+        float a = min(fill + rim, 1.0) * vColor.a;
+        FragColor = vec4(color * vColor.a, a);
+    }
+}
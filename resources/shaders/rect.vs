@@ -0,0 +1,35 @@
+#version 330 core
+// Rects: 2D affine fast path. Each instance carries its own offset/scale,
+// view shake is a single offset uniform — no matrices anywhere.
+// SDF shapes get a padded quad so their glow rim has room to fade out.
+layout (location = 0) in vec2 aPos;    // unit quad corner
+// Instances are packed (half floats, unorm8/16); vertex fetch unpacks them.
+layout (location = 1) in vec2 aCenter;
+layout (location = 2) in vec4 aColor;
+layout (location = 3) in vec2 aGlowShape; // x = glow, y = 0 rect / SDF shape id
+layout (location = 4) in vec4 aUV;     // atlas rect: xy = min, zw = max
+layout (location = 5) in vec2 aSize;
+uniform vec2 viewOffset;
+uniform float depth;   // per layer
+out vec3 vWorldPos;   // position after transform (NDC-ish during our simple pipeline)
+out vec4 vColor;
+out float vGlow;
+out vec2 vUV;
+flat out int vShape;
+out vec2 vLocal;      // offset from the center in world units
+flat out vec2 vSize;  // the shape's box
+
+const float SHAPE_PAD = 1.35;
+
+void main() {
+    vShape = int(aGlowShape.y + 0.5);
+    vec2 corner = vShape == 0 ? aPos : aPos * SHAPE_PAD;
+    vLocal = corner * aSize;
+    vSize = aSize;
+    vec2 p = vLocal + aCenter + viewOffset;
+    vWorldPos = vec3(p, 0.0);
+    vColor = aColor;
+    vGlow = aGlowShape.x;
+    vUV = mix(aUV.xy, aUV.zw, aPos + 0.5);
+    gl_Position = vec4(p, depth, 1.0);
+}
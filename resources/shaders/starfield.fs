@@ -0,0 +1,9 @@
+#version 330 core
+out vec4 FragColor;
+in float vAlpha;
+
+uniform float glow;    // same 1.2 boost the CPU stars used
+
+void main() {
+    FragColor = vec4(vec3(glow * vAlpha), vAlpha);   // premultiplied
+}
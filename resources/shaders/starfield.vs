@@ -0,0 +1,44 @@
+#version 330 core
+// Stateless parallax starfield: every star is a pure function of its index
+// and time, so the CPU only issues one instanced draw. Matches the old CPU
+// stars: layer picks speed/size/alpha, y drifts down and wraps at +-1.05,
+// and each wrap re-rolls x and alpha.
+uniform float time;
+uniform vec2  viewOffset;
+uniform float depth;
+out float vAlpha;
+
+uint hash(uint x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+float hash01(uint star, uint salt) {
+    return float(hash(star * 0x9e3779b9u + salt) >> 8) * (1.0 / 16777216.0);
+}
+
+const vec2 corners[6] = vec2[6](
+    vec2( 0.5,  0.5), vec2( 0.5, -0.5), vec2(-0.5, -0.5),
+    vec2( 0.5,  0.5), vec2(-0.5, -0.5), vec2(-0.5,  0.5));
+
+void main() {
+    uint id = uint(gl_InstanceID);
+    float layer = hash01(id, 0u);
+    float speed = 0.05 + layer * 0.25;            // parallax
+    float size  = 0.004 + layer * 0.01;
+
+    // distance fallen from the top edge, wrapped into one 2.1-tall cycle
+    float fallen = (1.05 - (hash01(id, 1u) * 2.1 - 1.05)) + speed * time;
+    float cycle  = floor(fallen / 2.1);
+    float y = 1.05 - (fallen - cycle * 2.1);
+    uint c = uint(cycle);
+    float x = hash01(id, 2u + c * 2u) * 2.0 - 1.0;
+    float alpha = 0.5 + hash01(id, 3u + c * 2u) * 0.5;
+
+    float twinkle = 0.85 + 0.15 * sin(time * (2.0 + speed * 6.0) + x * 10.0);
+    vAlpha = alpha * twinkle;
+
+    vec2 corner = corners[gl_VertexID];
+    gl_Position = vec4(vec2(x, y) + corner * size + viewOffset, depth, 1.0);
+}
@@ -0,0 +1,11 @@
+#version 330 core
+// Accumulated trails, added over the scene
+out vec4 FragColor;
+in vec2 vUV;
+
+uniform sampler2D source;
+uniform float intensity;
+
+void main() {
+    FragColor = vec4(texture(source, vUV).rgb * intensity, 1.0);
+}
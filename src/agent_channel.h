@@ -0,0 +1,254 @@
+// --------------------------------------------------------------------------
+//       agent_channel.h — shared-memory observations/actions for agents
+//    An external process (an RL agent, a test driver) plays the game
+//    through a POSIX shared-memory segment instead of fake keystrokes:
+//      obs ring     the game writes each tick's AgentObservation straight
+//                   into the next slot and bumps obsHead; the agent reads
+//                   the slot in place. No serialization, no copy.
+//      action ring  the agent answers observation `seq` by writing its
+//                   PlayerInput to actions[seq % ring] and bumping actHead.
+//    Heads are the only synchronization (release on write, acquire on
+//    read). A reader that lags by a whole ring sees stillValid() fail.
+//
+//    Lockstep: the game waits (up to a timeout, so a dead agent cannot
+//    hang it) for the answer to the observation it just published.
+//    Otherwise it keeps using the last action received. Either way the
+//    time from publish to answer is recorded as the round-trip latency.
+//
+//    POSIX only (shm_open/mmap); on Windows create/attach fail politely.
+// --------------------------------------------------------------------------
+#ifndef AGENT_CHANNEL_H
+#define AGENT_CHANNEL_H
+
+#include "game_state.h"
+#include "soak.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const uint32_t AGENT_RING = 16;
+const uint32_t AGENT_MAGIC = 0x47414247;    // "GBAG"
+const uint32_t AGENT_VERSION = 1;
+
+struct AgentObservation {
+    uint64_t seq;               // 1, 2, ...: matches obsHead once published
+    uint64_t publishNs;         // steady clock of the game process
+    uint32_t tick;
+    // score, player and bullet are those of the player the agent drives
+    int32_t  score, lives, gameOver;
+    float    playerX;
+    int32_t  bulletActive;
+    float    bulletX, bulletY;
+    uint32_t ghostCount;
+    float    ghostX[MAX_GHOSTS], ghostY[MAX_GHOSTS], ghostVX[MAX_GHOSTS];
+};
+
+struct AgentAction {
+    uint64_t obsSeq;            // the observation this answers
+    PlayerInput input;
+};
+
+struct AgentShared {
+    uint32_t magic, version, ring, obsSize;
+    alignas(64) std::atomic<uint64_t> obsHead;  // last published observation, 0 = none
+    alignas(64) std::atomic<uint64_t> actHead;  // last observation answered
+    alignas(64) AgentObservation obs[AGENT_RING];
+    AgentAction actions[AGENT_RING];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "heads are shared between processes");
+
+class AgentChannel {
+public:
+    bool lockstep = false;
+    int  timeoutMs = 1000;          // lockstep wait before giving up on a tick
+
+    // game side stats
+    FrameHistogram roundTrip;       // publish -> answer, ns
+    uint64_t published = 0, answered = 0, timeouts = 0;
+
+    ~AgentChannel() { close(); }
+
+    bool isOpen() const { return shared != nullptr; }
+
+    // Game side: create (or take over) the segment
+    bool create(const char* name)
+    {
+        if (!map(name, true)) return false;
+        memset(static_cast<void*>(shared), 0, sizeof(AgentShared));
+        shared->magic = AGENT_MAGIC;
+        shared->version = AGENT_VERSION;
+        shared->ring = AGENT_RING;
+        shared->obsSize = sizeof(AgentObservation);
+        shared->obsHead.store(0, std::memory_order_release);
+        shared->actHead.store(0, std::memory_order_release);
+        return true;
+    }
+
+    // Agent side: map a segment the game created
+    bool attach(const char* name)
+    {
+        if (!map(name, false)) return false;
+        if (shared->magic != AGENT_MAGIC || shared->version != AGENT_VERSION ||
+            shared->obsSize != sizeof(AgentObservation)) {
+            fprintf(stderr, "agent: %s is not a compatible channel\n", path.c_str());
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+#ifndef _WIN32
+        if (shared) munmap(shared, sizeof(AgentShared));
+        if (owner) shm_unlink(path.c_str());
+#endif
+        shared = nullptr;
+        owner = false;
+    }
+
+    // ---- game side ----
+    // Write the observation for `g`, as seen by `player` (the one the agent
+    // drives), straight into the next ring slot
+    void publish(const GameState& g, int player)
+    {
+        const PlayerState& pl = g.players[player];
+        uint64_t seq = shared->obsHead.load(std::memory_order_relaxed) + 1;
+        AgentObservation& o = shared->obs[seq % AGENT_RING];
+        o.seq = seq;
+        o.publishNs = nowNs();
+        o.tick = g.tick;
+        o.score = pl.score;
+        o.lives = g.lives;
+        o.gameOver = g.gameOver;
+        o.playerX = pl.x;
+        o.bulletActive = pl.bulletActive;
+        o.bulletX = pl.bulletX;
+        o.bulletY = pl.bulletY;
+        const GhostArchetype& ghosts = g.world;
+        o.ghostCount = ghosts.count;
+        for (uint32_t i = 0; i < ghosts.count; ++i) {
+            o.ghostX[i] = ghosts.column<GhostX>()[i].v;
+            o.ghostY[i] = ghosts.column<GhostY>()[i].v;
+            o.ghostVX[i] = ghosts.column<GhostVX>()[i].v;
+        }
+        shared->obsHead.store(seq, std::memory_order_release);
+        published++;
+    }
+
+    // Input for this tick: the answer to the last published observation
+    // in lockstep (waiting for it), else whatever the agent sent last
+    PlayerInput action()
+    {
+        uint64_t want = shared->obsHead.load(std::memory_order_relaxed);
+        if (lockstep && !waitFor(shared->actHead, want)) timeouts++;
+        uint64_t a = shared->actHead.load(std::memory_order_acquire);
+        if (a > lastAnswered) {
+            const AgentAction& act = shared->actions[a % AGENT_RING];
+            if (act.obsSeq == a) {
+                latched = act.input;
+                // the slot of `a` is still ours unless a full ring passed
+                if (want - a < AGENT_RING - 1)
+                    roundTrip.add(nowNs() - shared->obs[a % AGENT_RING].publishNs);
+                answered++;
+            }
+            lastAnswered = a;
+        }
+        return latched;
+    }
+
+    // ---- agent side ----
+    // Newest observation after `after`, read in place; nullptr on timeout
+    const AgentObservation* waitObservation(uint64_t after, int waitMs)
+    {
+        if (!waitFor(shared->obsHead, after + 1, waitMs)) return nullptr;
+        return &shared->obs[shared->obsHead.load(std::memory_order_acquire) % AGENT_RING];
+    }
+
+    // true if the game has not started overwriting observation `seq` yet;
+    // check after reading it in place
+    bool stillValid(uint64_t seq) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return shared->obsHead.load(std::memory_order_relaxed) < seq + AGENT_RING - 1;
+    }
+
+    void sendAction(uint64_t obsSeq, PlayerInput in)
+    {
+        AgentAction& a = shared->actions[obsSeq % AGENT_RING];
+        a.obsSeq = obsSeq;
+        a.input = in;
+        shared->actHead.store(obsSeq, std::memory_order_release);
+    }
+
+private:
+    AgentShared* shared = nullptr;
+    bool owner = false;
+    std::string path;
+    uint64_t lastAnswered = 0;
+    PlayerInput latched = 0;
+
+    static uint64_t nowNs()
+    {
+        using namespace std::chrono;
+        return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // spin briefly, then yield, until head >= target
+    bool waitFor(const std::atomic<uint64_t>& head, uint64_t target, int waitMs = -1)
+    {
+        if (waitMs < 0) waitMs = timeoutMs;
+        uint64_t deadline = nowNs() + (uint64_t)waitMs * 1000000ull;
+        for (int spins = 0; head.load(std::memory_order_acquire) < target; ++spins) {
+            if (spins > 256) {
+                if (nowNs() > deadline) return false;
+                std::this_thread::yield();
+            }
+        }
+        return true;
+    }
+
+    bool map(const char* name, bool create)
+    {
+        close();
+        path = name[0] == '/' ? name : std::string("/") + name;
+#ifndef _WIN32
+        int fd = shm_open(path.c_str(), create ? (O_CREAT | O_RDWR) : O_RDWR, 0600);
+        if (fd < 0) {
+            fprintf(stderr, "agent: cannot open shared memory %s\n", path.c_str());
+            return false;
+        }
+        if (create && ftruncate(fd, sizeof(AgentShared)) != 0) {
+            ::close(fd);
+            shm_unlink(path.c_str());
+            return false;
+        }
+        void* p = mmap(nullptr, sizeof(AgentShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            if (create) shm_unlink(path.c_str());
+            return false;
+        }
+        shared = static_cast<AgentShared*>(p);
+        owner = create;
+        return true;
+#else
+        (void)create;
+        fprintf(stderr, "agent: the shared-memory channel needs POSIX shm_open\n");
+        return false;
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,210 @@
+// --------------------------------------------------------------------------
+//              asset_loader.h — asynchronous image loading
+//    Worker threads read files and decode them with stbi_load_from_memory;
+//    the render thread uploads finished images into the atlas under a
+//    per-frame time budget. Until then a handle resolves to a placeholder.
+//    Images found in a mapped .pak skip all of that: they are already RGBA8
+//    and get uploaded straight from the mapping on request.
+// --------------------------------------------------------------------------
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "stb_image.h"
+#include "atlas.h"
+#include "asset_pack.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <iostream>
+
+typedef int AssetHandle;
+
+class AssetLoader {
+public:
+    // Per-asset timings, all in milliseconds
+    struct Metrics {
+        double readMs = 0, decodeMs = 0, waitMs = 0, uploadMs = 0, totalMs = 0;
+        size_t fileBytes = 0;
+    };
+
+    void start(Atlas* target, int workers = 2)
+    {
+        atlas = target;
+        if (workers < 1) workers = 1;
+        for (int i = 0; i < workers; ++i)
+            threads.emplace_back([this]{ workerLoop(); });
+    }
+
+    ~AssetLoader() { stop(); }
+
+    // Prefer pre-decoded images from a mapped archive (may be null)
+    void usePack(const AssetPack* p) { pack = p; }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quitting = true;
+        }
+        cv.notify_all();
+        for (auto& t : threads) t.join();
+        threads.clear();
+        for (auto& d : decoded) stbi_image_free(d.pixels);
+        decoded.clear();
+    }
+
+    // Queue an image; the handle is usable immediately (placeholder until loaded)
+    AssetHandle request(const char* path)
+    {
+        AssetHandle h = (AssetHandle)assets.size();
+        Asset a;
+        a.path = path;
+        a.sprite = atlas->white;
+        a.requested = clockMs();
+
+        const PackEntry* e = pack ? pack->find(path) : nullptr;
+        if (e && e->type == PACK_RGBA8) {
+            // zero-copy: the mapped bytes go straight to glTexSubImage2D
+            a.sprite = atlas->add((int)e->width, (int)e->height, pack->data(*e));
+            atlas->finalize();
+            a.loaded = true;
+            a.metrics.fileBytes = (size_t)e->size;
+            a.metrics.uploadMs = a.metrics.totalMs = clockMs() - a.requested;
+            assets.push_back(a);
+            printf("asset %-28s %7zu B  mapped from pack, upload %6.2f ms\n",
+                   a.path.c_str(), a.metrics.fileBytes, a.metrics.uploadMs);
+            return h;
+        }
+
+        assets.push_back(a);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            jobs.push_back(Job{ h, a.path, a.requested });
+            pending++;
+        }
+        cv.notify_one();
+        return h;
+    }
+
+    const Sprite& sprite(AssetHandle h) const { return assets[h].sprite; }
+    bool ready(AssetHandle h) const { return assets[h].loaded; }
+    bool idle() const { return pending == 0; }
+
+    // Render thread: upload decoded images until the budget is used up.
+    // At least one upload happens per call so loading always progresses.
+    void pump(double budgetMs)
+    {
+        double start = clockMs();
+        int uploaded = 0;
+        for (;;) {
+            Decoded d;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (decoded.empty()) break;
+                if (uploaded > 0 && clockMs() - start >= budgetMs) break;
+                d = decoded.front();
+                decoded.pop_front();
+            }
+            Asset& a = assets[d.handle];
+            a.metrics = d.metrics;
+            double t0 = clockMs();
+            a.metrics.waitMs = t0 - d.finished;
+            if (d.pixels) {
+                a.sprite = atlas->add(d.w, d.h, d.pixels);
+                stbi_image_free(d.pixels);
+            } else {
+                std::cout << "Failed to load texture " << a.path << "\n";
+            }
+            a.metrics.uploadMs = clockMs() - t0;
+            a.metrics.totalMs = clockMs() - a.requested;
+            a.loaded = true;
+            pending--;
+            uploaded++;
+            printf("asset %-28s %7zu B  read %6.2f  decode %6.2f  wait %6.2f  upload %6.2f  total %7.2f ms\n",
+                   a.path.c_str(), a.metrics.fileBytes, a.metrics.readMs, a.metrics.decodeMs,
+                   a.metrics.waitMs, a.metrics.uploadMs, a.metrics.totalMs);
+        }
+        if (uploaded) atlas->finalize();
+    }
+
+private:
+    struct Asset {
+        std::string path;
+        Sprite sprite;
+        bool loaded = false;
+        double requested = 0;
+        Metrics metrics;
+    };
+    struct Job {
+        AssetHandle handle;
+        std::string path;
+        double requested;
+    };
+    struct Decoded {
+        AssetHandle handle = -1;
+        unsigned char* pixels = nullptr;
+        int w = 0, h = 0;
+        double finished = 0;
+        Metrics metrics;
+    };
+
+    Atlas* atlas = nullptr;
+    const AssetPack* pack = nullptr;
+    std::vector<Asset> assets;          // render thread only
+    int pending = 0;                    // render thread only
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Job> jobs;
+    std::deque<Decoded> decoded;
+    std::vector<std::thread> threads;
+    bool quitting = false;
+
+    static double clockMs()
+    {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void workerLoop()
+    {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this]{ return quitting || !jobs.empty(); });
+                if (quitting) return;
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            Decoded d;
+            d.handle = job.handle;
+
+            double t0 = clockMs();
+            std::ifstream file(job.path, std::ios::binary);
+            std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)),
+                                              std::istreambuf_iterator<char>());
+            double t1 = clockMs();
+            int n;
+            if (!bytes.empty())
+                d.pixels = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &d.w, &d.h, &n, 4);
+            double t2 = clockMs();
+
+            d.metrics.fileBytes = bytes.size();
+            d.metrics.readMs = t1 - t0;
+            d.metrics.decodeMs = t2 - t1;
+            d.finished = t2;
+            std::lock_guard<std::mutex> lock(mtx);
+            decoded.push_back(d);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,191 @@
+// --------------------------------------------------------------------------
+//             asset_pack.h — packed asset archive (.pak)
+//    One file: header, index, then 16-byte aligned blobs. Images are stored
+//    pre-decoded as RGBA8 (bottom row first, like the GL upload wants), so
+//    the game maps the file and hands the bytes straight to glTexSubImage2D.
+//    Anything else (shader sources, level data) is stored as raw bytes.
+// --------------------------------------------------------------------------
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const uint32_t PACK_VERSION = 1;
+
+enum PackEntryType : uint32_t {
+    PACK_RAW   = 0,
+    PACK_RGBA8 = 1
+};
+
+struct PackHeader {
+    char     magic[4];     // "GBPK"
+    uint32_t version;
+    uint32_t count;        // entries in the index following the header
+    uint32_t reserved;
+};
+
+struct PackEntry {
+    char     name[56];     // path as given to the packer, NUL terminated
+    uint32_t type;         // PackEntryType
+    uint32_t width, height;
+    uint32_t reserved;
+    uint64_t offset;       // from start of file
+    uint64_t size;         // bytes
+};
+
+// ---- Writer (used by tools/pack_assets and the benchmarks) ----
+struct PackSource {
+    std::string name;
+    uint32_t type;
+    uint32_t width, height;
+    std::vector<unsigned char> bytes;
+};
+
+static inline bool writeAssetPack(const char* path, const std::vector<PackSource>& sources)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    PackHeader hdr;
+    memcpy(hdr.magic, "GBPK", 4);
+    hdr.version = PACK_VERSION;
+    hdr.count = (uint32_t)sources.size();
+    hdr.reserved = 0;
+
+    std::vector<PackEntry> index(sources.size());
+    uint64_t offset = sizeof(PackHeader) + sizeof(PackEntry) * sources.size();
+    for (size_t i = 0; i < sources.size(); ++i) {
+        offset = (offset + 15) & ~(uint64_t)15;
+        PackEntry& e = index[i];
+        memset(&e, 0, sizeof(e));
+        strncpy(e.name, sources[i].name.c_str(), sizeof(e.name) - 1);
+        e.type = sources[i].type;
+        e.width = sources[i].width;
+        e.height = sources[i].height;
+        e.offset = offset;
+        e.size = sources[i].bytes.size();
+        offset += e.size;
+    }
+    fwrite(&hdr, sizeof(hdr), 1, f);
+    fwrite(index.data(), sizeof(PackEntry), index.size(), f);
+    uint64_t pos = sizeof(PackHeader) + sizeof(PackEntry) * sources.size();
+    static const unsigned char zeros[16] = {};
+    for (size_t i = 0; i < sources.size(); ++i) {
+        fwrite(zeros, 1, (size_t)(index[i].offset - pos), f);
+        fwrite(sources[i].bytes.data(), 1, sources[i].bytes.size(), f);
+        pos = index[i].offset + index[i].size;
+    }
+    bool ok = ferror(f) == 0;
+    fclose(f);
+    return ok;
+}
+
+// ---- Reader: read-only memory mapping, entries point into the mapping ----
+class AssetPack {
+public:
+    ~AssetPack() { close(); }
+
+    bool open(const char* path)
+    {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER sz;
+        GetFileSizeEx(file, &sz);
+        size = (size_t)sz.QuadPart;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping) { close(); return false; }
+        base = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!base) { close(); return false; }
+#else
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) { close(); return false; }
+        size = (size_t)st.st_size;
+        void* p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { close(); return false; }
+        base = (const unsigned char*)p;
+#endif
+        if (!validate()) { close(); return false; }
+        return true;
+    }
+
+    void close()
+    {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap((void*)base, size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        base = nullptr;
+        size = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    uint32_t count() const { return header()->count; }
+    const PackEntry& entry(uint32_t i) const { return index()[i]; }
+    const unsigned char* data(const PackEntry& e) const { return base + e.offset; }
+
+    // linear scan: archives hold a handful of entries
+    const PackEntry* find(const char* name) const
+    {
+        if (!base) return nullptr;
+        for (uint32_t i = 0; i < count(); ++i)
+            if (strncmp(index()[i].name, name, sizeof(index()[i].name)) == 0)
+                return &index()[i];
+        return nullptr;
+    }
+
+private:
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+
+    const PackHeader* header() const { return (const PackHeader*)base; }
+    const PackEntry* index() const { return (const PackEntry*)(base + sizeof(PackHeader)); }
+
+    bool validate() const
+    {
+        if (size < sizeof(PackHeader)) return false;
+        const PackHeader* h = header();
+        if (memcmp(h->magic, "GBPK", 4) != 0 || h->version != PACK_VERSION) {
+            fprintf(stderr, "asset pack: bad magic or version\n");
+            return false;
+        }
+        if (h->count > (size - sizeof(PackHeader)) / sizeof(PackEntry)) return false;
+        for (uint32_t i = 0; i < h->count; ++i) {
+            const PackEntry& e = index()[i];
+            if (e.offset > size || e.size > size - e.offset) return false;   // no wrap-around
+            if (e.type == PACK_RGBA8 && (uint64_t)e.width * e.height * 4 != e.size) return false;
+        }
+        return true;
+    }
+};
+
+#endif
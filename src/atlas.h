@@ -0,0 +1,162 @@
+// --------------------------------------------------------------------------
+//                   atlas.h — texture atlas + sprites
+//    All images live in one RGBA8 texture packed with a skyline packer, so
+//    textured and flat rects share a single texture bind and draw call.
+//    A small white block is reserved first; flat rects sample it.
+// --------------------------------------------------------------------------
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "glad.h"
+#include <vector>
+#include <string>
+#include <climits>
+
+// UV rectangle of a packed image (u0,v0 = bottom-left, u1,v1 = top-right)
+struct Sprite {
+    float u0, v0, u1, v1;
+    int   w, h;           // size in texels, 0 if the image failed to pack
+};
+
+// Bottom-left skyline bin packer. The skyline is a list of horizontal
+// segments; each rect goes where its top edge ends up lowest.
+class SkylinePacker {
+public:
+    struct Node { int x, y, w; };
+
+    void init(int width, int height)
+    {
+        W = width; H = height;
+        skyline.clear();
+        skyline.push_back(Node{ 0, 0, width });
+    }
+
+    // returns false if the rect does not fit anywhere
+    bool insert(int w, int h, int& outX, int& outY)
+    {
+        int bestIdx = -1, bestTop = INT_MAX, bestW = INT_MAX, bestY = 0;
+        for (size_t i = 0; i < skyline.size(); ++i) {
+            int y;
+            if (!fits((int)i, w, h, y)) continue;
+            if (y + h < bestTop || (y + h == bestTop && skyline[i].w < bestW)) {
+                bestIdx = (int)i; bestTop = y + h; bestW = skyline[i].w; bestY = y;
+            }
+        }
+        if (bestIdx < 0) return false;
+        outX = skyline[bestIdx].x;
+        outY = bestY;
+        addLevel(bestIdx, outX, outY, w, h);
+        return true;
+    }
+
+private:
+    int W = 0, H = 0;
+    std::vector<Node> skyline;
+
+    // rect placed at skyline[i].x rests on the highest segment it spans
+    bool fits(int i, int w, int h, int& y) const
+    {
+        int x = skyline[i].x;
+        if (x + w > W) return false;
+        y = 0;
+        int left = w;
+        for (size_t j = i; left > 0; ++j) {
+            if (j >= skyline.size()) return false;
+            if (skyline[j].y > y) y = skyline[j].y;
+            if (y + h > H) return false;
+            left -= skyline[j].w;
+        }
+        return true;
+    }
+
+    void addLevel(int i, int x, int y, int w, int h)
+    {
+        skyline.insert(skyline.begin() + i, Node{ x, y + h, w });
+        // trim or drop segments now covered by the new one
+        for (size_t j = i + 1; j < skyline.size(); ) {
+            Node& prev = skyline[j - 1];
+            Node& cur  = skyline[j];
+            if (cur.x >= prev.x + prev.w) break;
+            int shrink = prev.x + prev.w - cur.x;
+            cur.x += shrink;
+            cur.w -= shrink;
+            if (cur.w <= 0) skyline.erase(skyline.begin() + j);
+            else break;
+        }
+        // merge neighbours at the same height
+        for (size_t j = 0; j + 1 < skyline.size(); ) {
+            if (skyline[j].y == skyline[j + 1].y) {
+                skyline[j].w += skyline[j + 1].w;
+                skyline.erase(skyline.begin() + j + 1);
+            } else {
+                ++j;
+            }
+        }
+    }
+};
+
+class Atlas {
+public:
+    static const int PADDING = 4;   // gutter between images so mips don't bleed
+    unsigned int texture = 0;
+    Sprite white{};                 // flat-color rects sample this
+
+    void initGL(int width, int height)
+    {
+        W = width; H = height;
+        packer.init(W, H);
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        std::vector<unsigned char> clear((size_t)W * H * 4, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, W, H, 0, GL_RGBA, GL_UNSIGNED_BYTE, clear.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // 8x8 white block; flat rects sample its center texel at a constant
+        // UV, so derivatives are zero and it always hits mip level 0
+        std::vector<unsigned char> px(8 * 8 * 4, 255);
+        Sprite s = add(8, 8, px.data());
+        float cu = (s.u0 + s.u1) * 0.5f, cv = (s.v0 + s.v1) * 0.5f;
+        white = Sprite{ cu, cv, cu, cv, 1, 1 };
+    }
+
+    // Pack and upload an RGBA8 image. Returns a zero-size sprite on overflow.
+    Sprite add(int w, int h, const unsigned char* rgba)
+    {
+        int x, y;
+        if (!packer.insert(w + PADDING * 2, h + PADDING * 2, x, y))
+            return Sprite{ white.u0, white.v0, white.u1, white.v1, 0, 0 };
+        x += PADDING; y += PADDING;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+        mipsDirty = true;
+        return Sprite{ (float)x / W, (float)y / H, (float)(x + w) / W, (float)(y + h) / H, w, h };
+    }
+
+    // Rebuild the mip chain once after a group of adds
+    void finalize()
+    {
+        if (!mipsDirty) return;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        mipsDirty = false;
+    }
+
+    void bind(int unit = 0) const
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+    void destroyGL() { glDeleteTextures(1, &texture); }
+
+private:
+    int W = 0, H = 0;
+    SkylinePacker packer;
+    bool mipsDirty = false;
+};
+
+#endif
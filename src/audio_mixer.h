@@ -0,0 +1,439 @@
+// --------------------------------------------------------------------------
+//          audio_mixer.h — sound effects mixed on a real-time thread
+//    The game side never touches audio state: play() pushes a small
+//    command into a lock-free SPSC ring (spsc_queue.h) and returns. The
+//    mixer thread drains the ring at the start of every buffer, mixes the
+//    active voices and hands the buffer to a backend.
+//      clips      synthesized once at init at a 22.05 kHz "source" rate
+//                 and resampled to the output rate, so mixing is a plain
+//                 multiply-add with no decoding or resampling per buffer
+//      mixing     four samples at a time (SSE), into planar float L/R,
+//                 then clamped and packed to interleaved int16
+//      backends   NullAudioBackend discards, WavAudioBackend writes a
+//                 .wav file; neither needs a sound device
+//    start() paces buffers in real time against a virtual device clock
+//    that is AUDIO_LEAD buffers ahead: a buffer not ready when its slot
+//    starts is an underrun. Without start(), renderFor() mixes offline as
+//    fast as the caller advances time (headless runs).
+//    Mix time per buffer and underruns are published every couple of
+//    seconds of audio through takeReport().
+// --------------------------------------------------------------------------
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+#include "game_state.h"
+#include "soak.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_MIX_SSE2 1
+#endif
+
+const int AUDIO_RATE = 48000;
+const int AUDIO_SOURCE_RATE = 22050;    // rate the clips are synthesized at
+const int AUDIO_BLOCK = 256;            // frames per buffer, ~5.3 ms
+const int AUDIO_LEAD = 2;               // buffers mixed ahead of the device
+const int AUDIO_MAX_VOICES = 32;
+
+enum SoundId : uint8_t {
+    SOUND_SHOT,
+    SOUND_KILL,
+    SOUND_LIFE_LOST,
+    SOUND_COUNT
+};
+
+enum AudioOp : uint8_t {
+    AUDIO_PLAY,
+    AUDIO_STOP_ALL
+};
+
+struct AudioCommand {
+    uint8_t op;
+    uint8_t sound;
+    float   gain;
+    float   pan;                // -1 left .. 1 right
+};
+
+// One report per couple of seconds of audio; totals since start
+struct AudioReport {
+    uint64_t seq;
+    uint64_t buffers, underruns, dropped;
+    uint64_t mixP50Ns, mixP99Ns, mixMaxNs;   // over the last interval
+    uint32_t peakVoices;                      // over the last interval
+};
+
+// ---------------------------------------------------------- backends ----
+class AudioBackend {
+public:
+    virtual ~AudioBackend() {}
+    // interleaved stereo int16, `frames` frames
+    virtual void write(const int16_t* samples, int frames) = 0;
+};
+
+class NullAudioBackend : public AudioBackend {
+public:
+    uint64_t frames = 0;
+    void write(const int16_t*, int n) override { frames += (uint64_t)n; }
+};
+
+class WavAudioBackend : public AudioBackend {
+public:
+    ~WavAudioBackend() { close(); }
+
+    bool open(const char* path)
+    {
+        close();
+        file = fopen(path, "wb");
+        if (!file) return false;
+        writeHeader(0);
+        return true;
+    }
+
+    void write(const int16_t* samples, int n) override
+    {
+        if (file) dataBytes += (uint32_t)fwrite(samples, 4, (size_t)n, file) * 4;
+    }
+
+    // sizes are only known at the end
+    void close()
+    {
+        if (!file) return;
+        fseek(file, 0, SEEK_SET);
+        writeHeader(dataBytes);
+        fclose(file);
+        file = nullptr;
+        dataBytes = 0;
+    }
+
+private:
+    FILE* file = nullptr;
+    uint32_t dataBytes = 0;
+
+    void writeHeader(uint32_t data)
+    {
+        // little-endian hosts only, like the rest of the binary formats here
+        struct {
+            char     riff[4]; uint32_t riffSize; char wave[4];
+            char     fmt[4];  uint32_t fmtSize;
+            uint16_t format, channels; uint32_t rate, byteRate; uint16_t blockAlign, bits;
+            char     data[4]; uint32_t dataSize;
+        } h = { { 'R','I','F','F' }, 36 + data, { 'W','A','V','E' },
+                { 'f','m','t',' ' }, 16, 1, 2, (uint32_t)AUDIO_RATE, (uint32_t)AUDIO_RATE * 4, 4, 16,
+                { 'd','a','t','a' }, data };
+        static_assert(sizeof(h) == 44, "packed WAV header");
+        fwrite(&h, sizeof(h), 1, file);
+    }
+};
+
+// ------------------------------------------------------------- mixer ----
+class AudioMixer {
+public:
+    float masterGain = 0.5f;
+
+    ~AudioMixer() { stop(); }
+
+    // Build the clips (the only allocations) and pick the output
+    void init(AudioBackend* backend)
+    {
+        out = backend;
+        std::vector<float> src;
+        synthShot(src);      resample(src, clips[SOUND_SHOT]);
+        synthKill(src);      resample(src, clips[SOUND_KILL]);
+        synthLifeLost(src);  resample(src, clips[SOUND_LIFE_LOST]);
+    }
+
+    // ---- game side (one producer thread) ----
+    void play(SoundId sound, float gain = 1.0f, float pan = 0.0f)
+    {
+        push({ AUDIO_PLAY, sound, gain, pan });
+    }
+
+    void stopAll() { push({ AUDIO_STOP_ALL, 0, 0.0f, 0.0f }); }
+
+    // sounds for one tick's SimEvents
+    void playEvents(uint32_t events)
+    {
+        if (events & EVENT_SHOT)      play(SOUND_SHOT, 0.6f);
+        if (events & EVENT_KILL)      play(SOUND_KILL, 0.9f);
+        if (events & EVENT_LIFE_LOST) play(SOUND_LIFE_LOST, 1.0f);
+    }
+
+    // ---- real-time thread ----
+    void start()
+    {
+        if (running.exchange(true)) return;
+        thread = std::thread([this] { run(); });
+    }
+
+    void stop()
+    {
+        if (!running.exchange(false)) return;
+        thread.join();
+    }
+
+    // ---- offline: mix as many buffers as `seconds` of audio need ----
+    void renderFor(double seconds)
+    {
+        owedFrames += seconds * AUDIO_RATE;
+        while (owedFrames >= AUDIO_BLOCK) {
+            mixBlock();
+            owedFrames -= AUDIO_BLOCK;
+        }
+    }
+
+    // ---- reporting (one consumer thread) ----
+    // true when a report newer than the last one taken is available
+    bool takeReport(AudioReport& r)
+    {
+        const AudioReport& latest = reports.acquire();
+        if (latest.seq == lastReportTaken) return false;
+        lastReportTaken = latest.seq;
+        r = latest;
+        return true;
+    }
+
+    // the report for whatever was mixed since the last one
+    void flushReport()
+    {
+        if (mixTime.frames()) publishReport();
+    }
+
+    // Mix one buffer: apply queued commands, sum the voices, output
+    void mixBlock()
+    {
+        using namespace std::chrono;
+        auto t0 = steady_clock::now();
+
+        AudioCommand c;
+        while (commands.pop(c)) apply(c);
+
+        memset(mixL, 0, sizeof(mixL));
+        memset(mixR, 0, sizeof(mixR));
+        if (voiceCount > peakVoices) peakVoices = voiceCount;
+        for (int v = 0; v < voiceCount;) {
+            Voice& vc = voices[v];
+            const Clip& clip = clips[vc.sound];
+            uint32_t left = clip.frames - vc.pos;
+            int n = left < (uint32_t)AUDIO_BLOCK ? (int)left : AUDIO_BLOCK;
+            // clips are zero-padded, so rounding n up to 4 adds silence
+            mixVoice(&clip.samples[vc.pos], (n + 3) & ~3, vc.gainL, vc.gainR);
+            vc.pos += (uint32_t)n;
+            if (vc.pos >= clip.frames) voices[v] = voices[--voiceCount];
+            else ++v;
+        }
+        toInt16();
+        out->write(pcm, AUDIO_BLOCK);
+
+        mixTime.add((uint64_t)duration_cast<nanoseconds>(steady_clock::now() - t0).count());
+        buffers++;
+        if (buffers % REPORT_BUFFERS == 0) publishReport();
+    }
+
+private:
+    static const uint32_t REPORT_BUFFERS = AUDIO_RATE * 2 / AUDIO_BLOCK;   // ~2 s
+
+    struct Clip {
+        std::vector<float> samples;     // mono, output rate, zero-padded
+        uint32_t frames = 0;
+    };
+    struct Voice {
+        uint32_t pos;
+        uint8_t  sound;
+        float    gainL, gainR;
+    };
+
+    AudioBackend* out = nullptr;
+    Clip clips[SOUND_COUNT];
+    SpscQueue<AudioCommand, 256> commands;
+    std::atomic<uint64_t> dropped{ 0 };
+
+    // mixer thread only
+    Voice voices[AUDIO_MAX_VOICES];
+    int   voiceCount = 0, peakVoices = 0;
+    alignas(16) float mixL[AUDIO_BLOCK];
+    alignas(16) float mixR[AUDIO_BLOCK];
+    alignas(16) int16_t pcm[AUDIO_BLOCK * 2];
+    FrameHistogram mixTime;
+    uint64_t buffers = 0, underruns = 0, reportSeq = 0;
+    double owedFrames = 0.0;
+
+    std::atomic<bool> running{ false };
+    std::thread thread;
+    TripleBuffer<AudioReport> reports;
+    uint64_t lastReportTaken = 0;
+
+    void push(const AudioCommand& c)
+    {
+        if (!commands.push(c)) dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void apply(const AudioCommand& c)
+    {
+        if (c.op == AUDIO_STOP_ALL) {
+            voiceCount = 0;
+            return;
+        }
+        if (c.sound >= SOUND_COUNT || !clips[c.sound].frames) return;
+        // all voices busy: steal the one furthest into its clip
+        int slot = voiceCount;
+        if (voiceCount == AUDIO_MAX_VOICES) {
+            slot = 0;
+            for (int v = 1; v < voiceCount; ++v)
+                if (voices[v].pos > voices[slot].pos) slot = v;
+        } else {
+            voiceCount++;
+        }
+        float pan = c.pan < -1.0f ? -1.0f : c.pan > 1.0f ? 1.0f : c.pan;
+        voices[slot].pos = 0;
+        voices[slot].sound = c.sound;
+        voices[slot].gainL = c.gain * (pan > 0.0f ? 1.0f - pan : 1.0f);
+        voices[slot].gainR = c.gain * (pan < 0.0f ? 1.0f + pan : 1.0f);
+    }
+
+    // mixL/R[0..n) += src * gain; n is a multiple of 4
+    void mixVoice(const float* src, int n, float gl, float gr)
+    {
+#ifdef AUDIO_MIX_SSE2
+        __m128 l = _mm_set1_ps(gl), r = _mm_set1_ps(gr);
+        for (int i = 0; i < n; i += 4) {
+            __m128 s = _mm_loadu_ps(src + i);
+            _mm_store_ps(mixL + i, _mm_add_ps(_mm_load_ps(mixL + i), _mm_mul_ps(s, l)));
+            _mm_store_ps(mixR + i, _mm_add_ps(_mm_load_ps(mixR + i), _mm_mul_ps(s, r)));
+        }
+#else
+        for (int i = 0; i < n; ++i) {
+            mixL[i] += src[i] * gl;
+            mixR[i] += src[i] * gr;
+        }
+#endif
+    }
+
+    // planar float -> interleaved int16, clamped
+    void toInt16()
+    {
+        const float scale = 32767.0f * masterGain;
+#ifdef AUDIO_MIX_SSE2
+        __m128 k = _mm_set1_ps(scale), lo = _mm_set1_ps(-32768.0f), hi = _mm_set1_ps(32767.0f);
+        for (int i = 0; i < AUDIO_BLOCK; i += 4) {
+            __m128i l = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_load_ps(mixL + i), k), lo), hi));
+            __m128i r = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_load_ps(mixR + i), k), lo), hi));
+            _mm_store_si128((__m128i*)(pcm + 2 * i),
+                            _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r)));
+        }
+#else
+        for (int i = 0; i < AUDIO_BLOCK; ++i) {
+            float l = std::fmin(std::fmax(mixL[i] * scale, -32768.0f), 32767.0f);
+            float r = std::fmin(std::fmax(mixR[i] * scale, -32768.0f), 32767.0f);
+            pcm[2 * i] = (int16_t)lrintf(l);
+            pcm[2 * i + 1] = (int16_t)lrintf(r);
+        }
+#endif
+    }
+
+    void publishReport()
+    {
+        AudioReport& r = reports.back();
+        r.seq = ++reportSeq;
+        r.buffers = buffers;
+        r.underruns = underruns;
+        r.dropped = dropped.load(std::memory_order_relaxed);
+        r.mixP50Ns = mixTime.percentile(50);
+        r.mixP99Ns = mixTime.percentile(99);
+        r.mixMaxNs = mixTime.max();
+        r.peakVoices = (uint32_t)peakVoices;
+        reports.publish();
+        mixTime.reset();
+        peakVoices = voiceCount;
+    }
+
+    // Virtual device: buffer k starts playing at `due`; it is mixed
+    // AUDIO_LEAD buffers earlier and is late if not done by then
+    void run()
+    {
+        using namespace std::chrono;
+        const auto period = duration_cast<steady_clock::duration>(duration<double>((double)AUDIO_BLOCK / AUDIO_RATE));
+        auto due = steady_clock::now() + period * AUDIO_LEAD;
+        while (running.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_until(due - period * AUDIO_LEAD);
+            mixBlock();
+            auto now = steady_clock::now();
+            if (now > due) {
+                underruns++;        // the device played silence; resync
+                due = now;
+            }
+            due += period;
+        }
+    }
+
+    // ---- clips ----
+    // Linear resample from the source rate, padded with silence so the
+    // mixer can read whole groups of four past the end
+    static void resample(const std::vector<float>& src, Clip& clip)
+    {
+        double step = (double)AUDIO_SOURCE_RATE / AUDIO_RATE;
+        clip.frames = (uint32_t)((src.size() - 1) / step) + 1;
+        clip.samples.assign(clip.frames + 4, 0.0f);
+        for (uint32_t i = 0; i < clip.frames; ++i) {
+            double x = i * step;
+            size_t j = (size_t)x;
+            float t = (float)(x - (double)j);
+            float b = j + 1 < src.size() ? src[j + 1] : 0.0f;
+            clip.samples[i] = src[j] + (b - src[j]) * t;
+        }
+    }
+
+    // short falling square chirp
+    static void synthShot(std::vector<float>& s)
+    {
+        const int n = AUDIO_SOURCE_RATE * 9 / 100;
+        s.resize(n);
+        double phase = 0.0;
+        for (int i = 0; i < n; ++i) {
+            float t = (float)i / n;
+            phase += (1400.0 - 800.0 * t) / AUDIO_SOURCE_RATE;
+            s[i] = (phase - std::floor(phase) < 0.5 ? 0.35f : -0.35f) * (1.0f - t) * (1.0f - t);
+        }
+    }
+
+    // noise burst over a dropping tone
+    static void synthKill(std::vector<float>& s)
+    {
+        const int n = AUDIO_SOURCE_RATE * 22 / 100;
+        s.resize(n);
+        SimRng rng = { 0x5eed1234u };
+        double phase = 0.0;
+        for (int i = 0; i < n; ++i) {
+            float t = (float)i / n;
+            phase += (330.0 - 220.0 * t) / AUDIO_SOURCE_RATE;
+            float noise = rng.range(-1.0f, 1.0f);
+            float tone = (float)std::sin(phase * 6.283185307179586);
+            s[i] = (0.5f * noise * (1.0f - t) * (1.0f - t) + 0.4f * tone) * (1.0f - t);
+        }
+    }
+
+    // long sliding wail with vibrato
+    static void synthLifeLost(std::vector<float>& s)
+    {
+        const int n = AUDIO_SOURCE_RATE * 65 / 100;
+        s.resize(n);
+        double phase = 0.0;
+        for (int i = 0; i < n; ++i) {
+            float t = (float)i / n;
+            double hz = 440.0 * std::pow(0.25, (double)t) * (1.0 + 0.03 * std::sin(t * 60.0));
+            phase += hz / AUDIO_SOURCE_RATE;
+            s[i] = 0.6f * (float)std::sin(phase * 6.283185307179586) * (1.0f - t);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,116 @@
+// --------------------------------------------------------------------------
+//               autopilot.h — scripted player for soak testing
+//    Reads only the GameState and answers with the same PlayerInput byte a
+//    keyboard would produce, so it drives the game through the normal input
+//    path (local play, versus, rollback).
+//      target    nearest ghost, held by EntityHandle across ticks and
+//                dropped as soon as the handle goes stale; a ghost close
+//                to the player line takes over as the more urgent target
+//      lead      the aim point is where the target will be when a bullet
+//                fired now reaches its height (wall bounces included)
+//      dodge     nothing in this game hurts on contact, so the bot dodges
+//                the other player instead: it never parks under them,
+//                which would just race them for the same ghost
+//      restart   presses restart on game over, so a run never ends
+// --------------------------------------------------------------------------
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "game_state.h"
+#include <cmath>
+
+class Autopilot {
+public:
+    int player = 0;
+    EntityHandle target = NULL_ENTITY;
+
+    // counters for the soak report
+    uint64_t retargets = 0, shots = 0, restarts = 0;
+
+    explicit Autopilot(int playerIndex = 0) : player(playerIndex) {}
+
+    PlayerInput think(const GameState& g)
+    {
+        if (g.gameOver) {
+            restarts++;
+            target = NULL_ENTITY;
+            return INPUT_RESTART;
+        }
+        const PlayerState& me = g.players[player];
+        const GhostArchetype& ghosts = g.world;
+        int i = ghosts.resolve(target);
+        int best = pickTarget(g, me.x);
+        // switch when the held ghost died or another one is about to land
+        if (i < 0 || (best >= 0 && best != i && urgent(ghosts.column<GhostY>()[best].v))) {
+            i = best;
+            target = i >= 0 ? ghosts.handle((uint32_t)i) : NULL_ENTITY;
+            retargets++;
+        }
+
+        float aim = 0.0f;
+        bool canHit = false;
+        if (i >= 0) {
+            float gx = ghosts.column<GhostX>()[i].v, gy = ghosts.column<GhostY>()[i].v;
+            float gvx = ghosts.column<GhostVX>()[i].v;
+            float flight = (gy - bulletStartY()) / BULLET_SPEED;
+            float walk = std::fabs(me.x - gx) / PLAYER_SPEED;
+            canHit = std::fabs(me.x - predictX(gx, gvx, flight)) < (BULLET_W + GHOST_W) * 0.35f;
+            aim = predictX(gx, gvx, flight + walk);
+        }
+        aim = avoidOtherPlayer(g, aim);
+
+        PlayerInput in = 0;
+        float deadzone = PLAYER_SPEED * SIM_DT;
+        if (aim < me.x - deadzone) in |= INPUT_LEFT;
+        if (aim > me.x + deadzone) in |= INPUT_RIGHT;
+        if (canHit && !me.bulletActive && me.shootTimer >= SHOOT_COOLDOWN) {
+            in |= INPUT_FIRE;
+            shots++;
+        }
+        return in;
+    }
+
+private:
+    // where simStep spawns bullets / where a ghost costs a life
+    static float bulletStartY() { return PLAYER_Y + PLAYER_H * 0.5f + BULLET_H * 0.6f; }
+    static float lineY() { return PLAYER_Y + PLAYER_H * 0.5f + GHOST_H * 0.5f; }
+
+    static bool urgent(float y) { return y < lineY() + GHOST_DROP * 2.5f; }
+
+    // nearest ghost to the player, ghosts close to the line first
+    int pickTarget(const GameState& g, float px) const
+    {
+        const GhostArchetype& ghosts = g.world;
+        int best = -1;
+        float bestD = 1e30f;
+        for (uint32_t k = 0; k < ghosts.count; ++k) {
+            float dx = ghosts.column<GhostX>()[k].v - px;
+            float dy = ghosts.column<GhostY>()[k].v - PLAYER_Y;
+            float d = dx * dx + dy * dy - (urgent(ghosts.column<GhostY>()[k].v) ? 100.0f : 0.0f);
+            if (d < bestD) { bestD = d; best = (int)k; }
+        }
+        return best;
+    }
+
+    // x after t seconds of straight motion, folded at the walls
+    static float predictX(float x, float vx, float t)
+    {
+        const float lo = -1.0f + GHOST_W * 0.5f, hi = 1.0f - GHOST_W * 0.5f, span = hi - lo;
+        float u = std::fmod(x - lo + vx * t, 2.0f * span);
+        if (u < 0.0f) u += 2.0f * span;
+        return lo + (u > span ? 2.0f * span - u : u);
+    }
+
+    float avoidOtherPlayer(const GameState& g, float aim) const
+    {
+        if (g.numPlayers < 2) return aim;
+        float other = g.players[player ^ 1].x;
+        if (std::fabs(aim - other) >= PLAYER_W) return aim;
+        float side = aim < other ? -1.0f : 1.0f;
+        float away = other + side * PLAYER_W;
+        if (away < -1.0f + PLAYER_W * 0.5f || away > 1.0f - PLAYER_W * 0.5f) away = other - side * PLAYER_W;
+        return away;
+    }
+};
+
+#endif
@@ -0,0 +1,341 @@
+// --------------------------------------------------------------------------
+//         batch_env.h — many game instances stepped in lockstep (RL)
+//    Training wants thousands of games per second, not one window. A
+//    BatchEnv holds N independent single-player games with every field
+//    laid out SoA *across instances*: ghost slot g of all games is one
+//    contiguous float array, so the ghost update runs four games per SSE
+//    step with the same branchless math as ghost_kernel.h.
+//
+//    Rules match simStep() (same constants, waves, speed-up per kill), minus
+//    particles and the restart key, which only matter on screen. Until the
+//    first kill a lane follows simStep bit for bit (checksum() matches
+//    batchChecksum() of the GameState); after it the RNG streams part,
+//    since simStep draws the explosion's particles from the same RNG.
+//
+//      actions    one PlayerInput byte per instance (LEFT/RIGHT/FIRE)
+//      reward     +1 per ghost shot, -1 per ghost reaching the line
+//      done       out of lives or maxEpisodeTicks reached; the instance
+//                 is reset in the same step (its RNG stream continues),
+//                 so the observation returned is already the new episode
+//      obs        [N][BATCH_OBS_SIZE] floats, see observe()
+//
+//    Each instance has its own seed; the same seeds and actions replay the
+//    same episodes. step() is single threaded; callers that want more
+//    cores run one BatchEnv per thread.
+// --------------------------------------------------------------------------
+#ifndef BATCH_ENV_H
+#define BATCH_ENV_H
+
+#include "game_state.h"
+#include "ghost_kernel.h"
+#include <cstdint>
+#include <vector>
+
+// player x, bullet on/x/y, can shoot, lives / 3, then per ghost slot:
+// alive, x, y, vx (zeros for dead slots)
+const int BATCH_OBS_SIZE = 6 + MAX_GHOSTS * 4;
+
+// FNV-1a over the scalar state; ghosts are hashed one by one and summed,
+// because simStep compacts its ghost pool while a lane keeps fixed slots
+struct BatchLaneSum {
+    uint64_t h = 1469598103934665603ull, ghosts = 0;
+
+    static uint64_t fnv(uint64_t h, const void* p, size_t n)
+    {
+        const unsigned char* b = (const unsigned char*)p;
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ull; }
+        return h;
+    }
+    void mix(const void* p, size_t n) { h = fnv(h, p, n); }
+    void ghost(float x, float y, float vx, float phase)
+    {
+        float v[4] = { x, y, vx, phase };
+        ghosts += fnv(1469598103934665603ull, v, sizeof(v));
+    }
+    uint64_t value() const { return fnv(h, &ghosts, sizeof(ghosts)); }
+};
+
+// The same sum for player 0 of a GameState (particles are not part of it)
+inline uint64_t batchChecksum(const GameState& g)
+{
+    BatchLaneSum sum;
+    const PlayerState& pl = g.players[0];
+    sum.mix(&g.tick, 4);
+    sum.mix(&g.lives, 4);
+    sum.mix(&g.rng.s, 4);
+    sum.mix(&pl.x, 4);
+    sum.mix(&pl.shootTimer, 4);
+    sum.mix(&pl.bulletActive, 4);
+    sum.mix(&pl.bulletX, 4);
+    sum.mix(&pl.bulletY, 4);
+    sum.mix(&pl.score, 4);
+    const GhostArchetype& ghosts = g.world;
+    for (uint32_t i = 0; i < ghosts.count; ++i)
+        sum.ghost(ghosts.column<GhostX>()[i].v, ghosts.column<GhostY>()[i].v,
+                  ghosts.column<GhostVX>()[i].v, ghosts.column<GhostPhase>()[i].v);
+    return sum.value();
+}
+
+class BatchEnv {
+public:
+    int maxEpisodeTicks = 60 * 60 * 3;      // truncate after three minutes
+    uint64_t episodes = 0;                  // finished since init()
+
+    // seeds: one per instance, or nullptr for 1..N
+    void init(int numEnvs, const uint32_t* seeds = nullptr)
+    {
+        n = numEnvs;
+        lanes = (n + 3) & ~3;               // padding lanes stay empty
+        for (std::vector<float>* v : { &px, &shootTimer, &bulletOn, &bx, &by, &kills, &lost, &aliveN })
+            v->assign(lanes, 0.0f);
+        for (std::vector<float>* v : { &gx, &gy, &gvx, &gphase, &galive })
+            v->assign((size_t)lanes * MAX_GHOSTS, 0.0f);
+        lives.assign(lanes, 0);
+        scores.assign(lanes, 0);
+        tick.assign(lanes, 0);
+        rng.assign(lanes, 0);
+        episodes = 0;
+        for (int i = 0; i < n; ++i) {
+            uint32_t s = seeds ? seeds[i] : (uint32_t)i + 1;
+            rng[i] = s ? s : 0x9e3779b9u;
+            resetInstance(i);
+        }
+    }
+
+    int size() const { return n; }
+
+    // Advance every instance one SIM_DT tick. obs may be nullptr.
+    void step(const PlayerInput* actions, float* rewards, uint8_t* dones, float* obs = nullptr)
+    {
+        const float dt = SIM_DT;
+
+        // players and bullets
+        for (int i = 0; i < n; ++i) {
+            // same operations in the same order as simStep, so x rounds the same
+            PlayerInput a = actions[i];
+            float x = px[i];
+            if (a & INPUT_LEFT)  x -= PLAYER_SPEED * dt;
+            if (a & INPUT_RIGHT) x += PLAYER_SPEED * dt;
+            if (x + PLAYER_W * 0.5f > 1.0f)  x = 1.0f - PLAYER_W * 0.5f;
+            if (x - PLAYER_W * 0.5f < -1.0f) x = -1.0f + PLAYER_W * 0.5f;
+            px[i] = x;
+            float st = shootTimer[i] + dt;
+            if ((a & INPUT_FIRE) && bulletOn[i] == 0.0f && st >= SHOOT_COOLDOWN) {
+                bulletOn[i] = 1.0f;
+                bx[i] = x;
+                by[i] = PLAYER_Y + PLAYER_H * 0.5f + BULLET_H * 0.6f;
+                st = 0.0f;
+            }
+            shootTimer[i] = st;
+            if (bulletOn[i] != 0.0f) {
+                by[i] += BULLET_SPEED * dt;
+                if (by[i] > 1.1f) bulletOn[i] = 0.0f;
+            }
+            kills[i] = lost[i] = 0.0f;
+        }
+
+        // ghosts, one slot across all games at a time; a slot's hit test
+        // sees the bullet already taken by a lower slot, which is the
+        // "first ghost hit takes the bullet" rule of simStep
+        for (int g = 0; g < MAX_GHOSTS; ++g)
+            stepGhostSlot(g);
+        std::fill(aliveN.begin(), aliveN.end(), 0.0f);
+        for (int g = 0; g < MAX_GHOSTS; ++g) {
+            float* vx = &gvx[(size_t)g * lanes];
+            const float* on = &galive[(size_t)g * lanes];
+            for (int i = 0; i < lanes; ++i) {
+                vx[i] *= 1.0f + 0.035f * kills[i];
+                aliveN[i] += on[i];
+            }
+        }
+
+        // bookkeeping: score, lives, waves, episode ends
+        for (int i = 0; i < n; ++i) {
+            scores[i] += 10 * (int)kills[i];
+            lives[i] -= (int)lost[i];
+            tick[i]++;
+            rewards[i] = kills[i] - lost[i];
+            bool done = lives[i] <= 0 || (int)tick[i] >= maxEpisodeTicks;
+            dones[i] = done ? 1 : 0;
+            if (done) {
+                episodes++;
+                resetInstance(i);
+            } else if (aliveN[i] == 0.0f) {
+                spawnWave(i, std::min(MAX_GHOSTS, 4 + scores[i] / 20), 1.0f + scores[i] / 100.0f);
+            }
+        }
+        if (obs) observe(obs);
+    }
+
+    void observe(float* obs) const
+    {
+        for (int i = 0; i < n; ++i) {
+            float* o = obs + (size_t)i * BATCH_OBS_SIZE;
+            o[0] = px[i];
+            o[1] = bulletOn[i];
+            o[2] = bulletOn[i] != 0.0f ? bx[i] : 0.0f;
+            o[3] = bulletOn[i] != 0.0f ? by[i] : 0.0f;
+            o[4] = shootTimer[i] >= SHOOT_COOLDOWN ? 1.0f : 0.0f;
+            o[5] = lives[i] * (1.0f / 3.0f);
+            for (int g = 0; g < MAX_GHOSTS; ++g) {
+                size_t k = (size_t)g * lanes + i;
+                float on = galive[k];
+                o[6 + g * 4 + 0] = on;
+                o[6 + g * 4 + 1] = on != 0.0f ? gx[k] : 0.0f;
+                o[6 + g * 4 + 2] = on != 0.0f ? gy[k] : 0.0f;
+                o[6 + g * 4 + 3] = on != 0.0f ? gvx[k] : 0.0f;
+            }
+        }
+    }
+
+    int score(int i) const { return scores[i]; }
+
+    // What lane i shares with a single-player GameState, see batchChecksum()
+    uint64_t checksum(int i) const
+    {
+        BatchLaneSum sum;
+        sum.mix(&tick[i], 4);
+        sum.mix(&lives[i], 4);
+        sum.mix(&rng[i], 4);
+        sum.mix(&px[i], 4);
+        sum.mix(&shootTimer[i], 4);
+        int32_t on = bulletOn[i] != 0.0f;
+        sum.mix(&on, 4);
+        sum.mix(&bx[i], 4);
+        sum.mix(&by[i], 4);
+        sum.mix(&scores[i], 4);
+        for (int g = 0; g < MAX_GHOSTS; ++g) {
+            size_t k = (size_t)g * lanes + i;
+            if (galive[k] != 0.0f) sum.ghost(gx[k], gy[k], gvx[k], gphase[k]);
+        }
+        return sum.value();
+    }
+
+private:
+    int n = 0, lanes = 0;
+
+    // per instance
+    std::vector<float> px, shootTimer, bulletOn, bx, by;
+    std::vector<float> kills, lost, aliveN; // this step: 0..1, 0..8, live ghosts
+    std::vector<int32_t> lives, scores;
+    std::vector<uint32_t> tick, rng;
+
+    // per ghost slot, across instances: [slot * lanes + instance]
+    std::vector<float> gx, gy, gvx, gphase, galive;
+
+    // SimRng, one stream per instance
+    uint32_t next(int i)
+    {
+        uint32_t& s = rng[i];
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        return s;
+    }
+    float rand(int i, float a, float b) { return a + (b - a) * (float)(next(i) >> 8) * (1.0f / 16777216.0f); }
+
+    void spawnWave(int i, int count, float speedScale)
+    {
+        for (int g = 0; g < MAX_GHOSTS; ++g) {
+            size_t k = (size_t)g * lanes + i;
+            galive[k] = g < count ? 1.0f : 0.0f;
+            if (g >= count) continue;
+            gx[k] = rand(i, -0.85f, 0.85f);
+            gy[k] = rand(i, 0.20f, 0.90f);
+            float sp = rand(i, GHOST_SPEED_MIN, GHOST_SPEED_MAX) * speedScale;
+            gvx[k] = (next(i) & 1) ? sp : -sp;
+            gphase[k] = rand(i, 0.0f, 6.28318f);
+        }
+    }
+
+    void resetInstance(int i)
+    {
+        px[i] = 0.0f;
+        shootTimer[i] = 0.0f;
+        bulletOn[i] = 0.0f;
+        bx[i] = 0.0f;
+        by[i] = -1.5f;
+        lives[i] = 3;
+        scores[i] = 0;
+        tick[i] = 0;
+        spawnWave(i, 6, 1.0f);
+    }
+
+    void stepGhostSlot(int g)
+    {
+        const float dt = SIM_DT;
+        const float halfW = GHOST_W * 0.5f;
+        const float lineYv = PLAYER_Y + PLAYER_H * 0.5f + GHOST_H * 0.5f;
+        const float hitX = (BULLET_W + GHOST_W) * 0.5f, hitY = (BULLET_H + GHOST_H) * 0.5f;
+        float* x = &gx[(size_t)g * lanes];
+        float* y = &gy[(size_t)g * lanes];
+        float* vx = &gvx[(size_t)g * lanes];
+        const float* phase = &gphase[(size_t)g * lanes];
+        float* alive = &galive[(size_t)g * lanes];
+        int i = 0;
+#ifdef GHOST_KERNEL_SSE2
+        const __m128 vdt = _mm_set1_ps(dt), bobAmp = _mm_set1_ps(0.12f * dt), two = _mm_set1_ps(2.0f);
+        const __m128 rightWall = _mm_set1_ps(1.0f - halfW), leftWall = _mm_set1_ps(-1.0f + halfW);
+        const __m128 drop = _mm_set1_ps(GHOST_DROP), lineY = _mm_set1_ps(lineYv);
+        const __m128 signBit = _mm_set1_ps(-0.0f), one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps();
+        const __m128 hx = _mm_set1_ps(hitX), hy = _mm_set1_ps(hitY);
+        for (; i + 4 <= lanes; i += 4) {
+            __m128 px4 = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i);
+            __m128 v = _mm_loadu_ps(vx + i), ph = _mm_loadu_ps(phase + i);
+            // simStep's kernel time is the tick count after the increment
+            __m128i t = _mm_add_epi32(_mm_loadu_si128((const __m128i*)&tick[i]), _mm_set1_epi32(1));
+            // tick * dt, then * 2, rounded in the same steps as simStep's kp.time
+            __m128 t2 = _mm_mul_ps(_mm_mul_ps(_mm_cvtepi32_ps(t), vdt), two);
+
+            px4 = _mm_add_ps(px4, _mm_add_ps(_mm_mul_ps(v, vdt), _mm_mul_ps(ghostSin4(_mm_add_ps(t2, ph)), bobAmp)));
+            __m128 right = _mm_cmpgt_ps(px4, rightWall);
+            __m128 left  = _mm_cmplt_ps(px4, leftWall);
+            __m128 bounced = _mm_or_ps(right, left);
+            px4 = _mm_or_ps(_mm_andnot_ps(bounced, px4),
+                            _mm_or_ps(_mm_and_ps(right, rightWall), _mm_and_ps(left, leftWall)));
+            __m128 absV = _mm_andnot_ps(signBit, v);
+            v = _mm_or_ps(_mm_andnot_ps(bounced, v),
+                          _mm_or_ps(_mm_and_ps(right, _mm_or_ps(absV, signBit)), _mm_and_ps(left, absV)));
+            py = _mm_sub_ps(py, _mm_and_ps(bounced, drop));
+
+            __m128 on = _mm_cmpgt_ps(_mm_loadu_ps(alive + i), zero);
+            __m128 reached = _mm_and_ps(on, _mm_cmple_ps(py, lineY));
+            on = _mm_andnot_ps(reached, on);
+            __m128 bullet = _mm_cmpgt_ps(_mm_loadu_ps(&bulletOn[i]), zero);
+            __m128 hit = _mm_and_ps(_mm_and_ps(on, bullet),
+                         _mm_and_ps(_mm_cmplt_ps(_mm_andnot_ps(signBit, _mm_sub_ps(_mm_loadu_ps(&bx[i]), px4)), hx),
+                                    _mm_cmplt_ps(_mm_andnot_ps(signBit, _mm_sub_ps(_mm_loadu_ps(&by[i]), py)), hy)));
+            on = _mm_andnot_ps(hit, on);
+
+            _mm_storeu_ps(x + i, px4);
+            _mm_storeu_ps(y + i, py);
+            _mm_storeu_ps(vx + i, v);
+            _mm_storeu_ps(alive + i, _mm_and_ps(on, one));
+            _mm_storeu_ps(&bulletOn[i], _mm_and_ps(_mm_andnot_ps(hit, bullet), one));
+            _mm_storeu_ps(&kills[i], _mm_add_ps(_mm_loadu_ps(&kills[i]), _mm_and_ps(hit, one)));
+            _mm_storeu_ps(&lost[i], _mm_add_ps(_mm_loadu_ps(&lost[i]), _mm_and_ps(reached, one)));
+        }
+#endif
+        GhostKernelParams k;
+        k.dt = dt;
+        k.halfW = halfW;
+        k.drop = GHOST_DROP;
+        k.lineY = lineYv;
+        k.hitX = hitX;
+        k.hitY = hitY;
+        for (; i < lanes; ++i) {
+            k.time = (float)(tick[i] + 1) * dt;
+            k.bulletActive = bulletOn[i] != 0.0f;
+            k.bulletX = bx[i];
+            k.bulletY = by[i];
+            bool reached, hit;
+            ghostStep1(x[i], y[i], vx[i], phase[i], k, reached, hit);
+            bool on = alive[i] != 0.0f;
+            reached = reached && on;
+            hit = hit && on && !reached;
+            alive[i] = on && !reached && !hit ? 1.0f : 0.0f;
+            if (hit) { bulletOn[i] = 0.0f; kills[i] += 1.0f; }
+            if (reached) lost[i] += 1.0f;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,151 @@
+// --------------------------------------------------------------------------
+//                 bloom.h — HDR bloom post-process
+//    Adds its passes to the frame graph, reading the HDR scene:
+//      bright   full    -> half     (threshold + 2x downsample)
+//      blur     half    -> half     (separable Gaussian, H then V)
+//      down     half    -> quarter
+//      blur     quarter -> quarter
+//      composite scene + half + quarter -> output
+//    Quality picks the Gaussian radius; Off adds no passes.
+//    Intermediate targets are transient; the graph pools and aliases them.
+// --------------------------------------------------------------------------
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include "glad.h"
+#include "shader_m.h"
+#include "frame_graph.h"
+#include <cmath>
+#include <vector>
+
+enum BloomQuality { BLOOM_OFF = 0, BLOOM_LOW, BLOOM_MEDIUM, BLOOM_HIGH, BLOOM_QUALITY_COUNT };
+
+static const char* const BLOOM_QUALITY_NAMES[BLOOM_QUALITY_COUNT] = { "off", "low (5 taps)", "medium (9 taps)", "high (13 taps)" };
+
+class Bloom {
+public:
+    BloomQuality quality = BLOOM_MEDIUM;
+    float threshold = 1.0f;
+    float intensity = 0.8f;
+
+    Shader* bright = nullptr;
+    Shader* blur = nullptr;
+    Shader* composite = nullptr;
+
+    void initGL()
+    {
+        bright    = new Shader("resources/shaders/post.vs", "resources/shaders/bloom_bright.fs");
+        blur      = new Shader("resources/shaders/post.vs", "resources/shaders/bloom_blur.fs");
+        composite = new Shader("resources/shaders/post.vs", "resources/shaders/bloom_composite.fs");
+        glGenVertexArrays(1, &vao);
+    }
+
+    bool enabled() const { return quality != BLOOM_OFF; }
+
+    void cycleQuality() { quality = (BloomQuality)((quality + 1) % BLOOM_QUALITY_COUNT); }
+
+    // Declare the bloom chain: reads `scene`, writes the composite to `output`
+    void addPasses(FrameGraph& fg, FGResource scene, FGResource output)
+    {
+        radius = quality == BLOOM_LOW ? 2 : quality == BLOOM_MEDIUM ? 4 : 6;
+        gaussianWeights(radius, weights);
+
+        FGTextureDesc halfDesc, quarterDesc;
+        halfDesc.scale = 0.5f;
+        quarterDesc.scale = 0.25f;
+        FGResource brightHalf = fg.createTexture("bloom bright", halfDesc);
+        FGResource blurHalfH  = fg.createTexture("bloom half h", halfDesc);
+        FGResource blurHalf   = fg.createTexture("bloom half", halfDesc);
+        FGResource downQ      = fg.createTexture("bloom quarter down", quarterDesc);
+        FGResource blurQH     = fg.createTexture("bloom quarter h", quarterDesc);
+        FGResource blurQ      = fg.createTexture("bloom quarter", quarterDesc);
+
+        fg.addPass("bright", { scene }, brightHalf, [this, scene](FrameGraph& g) {
+            downsample(g.texture(scene), 1.0f / g.width(), 1.0f / g.height(), threshold, 0.5f);
+        });
+        fg.addPass("blur half h", { brightHalf }, blurHalfH, [this, brightHalf](FrameGraph& g) {
+            blurPass(g.texture(brightHalf), 1.0f / g.outputWidth(), 0.0f);
+        });
+        fg.addPass("blur half v", { blurHalfH }, blurHalf, [this, blurHalfH](FrameGraph& g) {
+            blurPass(g.texture(blurHalfH), 0.0f, 1.0f / g.outputHeight());
+        });
+        fg.addPass("down quarter", { blurHalf }, downQ, [this, blurHalf](FrameGraph& g) {
+            downsample(g.texture(blurHalf), 2.0f / g.width(), 2.0f / g.height(), 0.0f, 0.0f);
+        });
+        fg.addPass("blur quarter h", { downQ }, blurQH, [this, downQ](FrameGraph& g) {
+            blurPass(g.texture(downQ), 1.0f / g.outputWidth(), 0.0f);
+        });
+        fg.addPass("blur quarter v", { blurQH }, blurQ, [this, blurQH](FrameGraph& g) {
+            blurPass(g.texture(blurQH), 0.0f, 1.0f / g.outputHeight());
+        });
+        fg.addPass("composite", { scene, blurHalf, blurQ }, output, [this, scene, blurHalf, blurQ](FrameGraph& g) {
+            glBindVertexArray(vao);
+            composite->use();
+            composite->setInt("scene", 0);
+            composite->setInt("bloomHalf", 1);
+            composite->setInt("bloomQuarter", 2);
+            composite->setFloat("intensity", intensity);
+            bindTexture(0, g.texture(scene));
+            bindTexture(1, g.texture(blurHalf));
+            bindTexture(2, g.texture(blurQ));
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            glActiveTexture(GL_TEXTURE0);
+        });
+    }
+
+    void destroyGL()
+    {
+        glDeleteVertexArrays(1, &vao);
+        for (Shader* s : { bright, blur, composite }) {
+            glDeleteProgram(s->ID);
+            delete s;
+        }
+    }
+
+private:
+    GLuint vao = 0;
+    int radius = 4;
+    float weights[8];
+
+    static void gaussianWeights(int radius, float* w)
+    {
+        float sigma = radius * 0.5f + 0.5f, sum = 0.0f;
+        for (int i = 0; i < 8; ++i) {
+            w[i] = i <= radius ? std::exp(-(float)(i * i) / (2.0f * sigma * sigma)) : 0.0f;
+            sum += (i == 0 ? 1.0f : 2.0f) * w[i];
+        }
+        for (int i = 0; i < 8; ++i) w[i] /= sum;
+    }
+
+    void downsample(GLuint source, float texelX, float texelY, float thresh, float knee)
+    {
+        glBindVertexArray(vao);
+        bright->use();
+        bright->setInt("source", 0);
+        bright->setVec2("texel", texelX, texelY);
+        bright->setFloat("threshold", thresh);
+        bright->setFloat("knee", knee);
+        bindTexture(0, source);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    void blurPass(GLuint source, float dirX, float dirY)
+    {
+        glBindVertexArray(vao);
+        blur->use();
+        blur->setInt("source", 0);
+        blur->setInt("radius", radius);
+        glUniform1fv(glGetUniformLocation(blur->ID, "weights"), 8, weights);
+        blur->setVec2("direction", dirX, dirY);
+        bindTexture(0, source);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    static void bindTexture(int unit, GLuint tex)
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, tex);
+    }
+};
+
+#endif
@@ -0,0 +1,40 @@
+// --------------------------------------------------------------------------
+//              components.h — game components and archetypes
+// --------------------------------------------------------------------------
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "ecs.h"
+#include "ghost_kernel.h"
+
+struct Position { float x, y; };
+struct Velocity { float x, y; };
+
+// Ghosts are split into one float per component so each column is a plain
+// float array the SIMD movement kernel can stream through (ghost_kernel.h)
+struct GhostX     { float v; };
+struct GhostY     { float v; };
+struct GhostVX    { float v; };  // horizontal velocity (sign gives direction)
+struct GhostPhase { float v; };  // per-ghost sine wave offset
+
+struct ParticleLife {
+    float life;     // 0..1
+    float size;
+};
+
+static_assert(sizeof(GhostX) == sizeof(float), "ghost columns must be float arrays");
+
+const int MAX_GHOSTS    = 8;
+const int MAX_PARTICLES = 1024;
+
+typedef Archetype<MAX_GHOSTS, GhostX, GhostY, GhostVX, GhostPhase> GhostArchetype;
+typedef Archetype<MAX_PARTICLES, Position, Velocity, ParticleLife> ParticleArchetype;
+
+// column of a float component as float*, for kernels
+template<typename C, typename A>
+inline float* floatColumn(A& a) { return reinterpret_cast<float*>(a.template column<C>()); }
+
+// stars are not entities: the GPU derives them from time (starfield.h)
+typedef Registry<GhostArchetype, ParticleArchetype> GameWorld;
+
+#endif
@@ -0,0 +1,241 @@
+// --------------------------------------------------------------------------
+//             ecs.h — compact archetype-based entity storage
+//    An archetype is a fixed set of component types stored as dense,
+//    cache-line aligned arrays (one per component, SoA). A registry is a
+//    set of archetypes; each<Cs...>() visits every archetype that has all
+//    of Cs and runs a tight loop over its live range.
+//
+//    Structural changes are deferred: spawn() writes into the slots past
+//    the live range and destroy() records a handle; both take effect in
+//    flush(), so systems can spawn/kill while iterating. flush() adds the
+//    spawns first, so an entity spawned and destroyed before the same
+//    flush never shows up. Removal is an O(1) swap with the last live
+//    entity, so storage never has holes.
+//
+//    Dense indices move on removal; anything that must keep referring to
+//    one entity holds an EntityHandle (slot + generation) instead. A handle
+//    to a removed entity resolves to -1, even after its slot is reused.
+//
+//    Everything is fixed-capacity and trivially copyable.
+// --------------------------------------------------------------------------
+#ifndef ECS_H
+#define ECS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+const size_t ECS_CACHE_LINE = 64;
+
+template<size_t N, typename C>
+struct ComponentColumn {
+    static_assert(std::is_trivially_copyable<C>::value, "components must be trivially copyable");
+    alignas(ECS_CACHE_LINE) C data[N];
+};
+
+template<typename T, typename... Ts>
+struct ecs_contains : std::disjunction<std::is_same<T, Ts>...> {};
+
+struct EntityHandle {
+    uint32_t slot;
+    uint32_t generation;    // 0 is never issued, so {0,0} is a null handle
+
+    bool operator==(const EntityHandle& o) const { return slot == o.slot && generation == o.generation; }
+    bool operator!=(const EntityHandle& o) const { return !(*this == o); }
+};
+
+const EntityHandle NULL_ENTITY = { 0, 0 };
+
+template<size_t Capacity, typename... Cs>
+struct Archetype : ComponentColumn<Capacity, Cs>... {
+    static constexpr size_t capacity = Capacity;
+
+    uint32_t count = 0;         // live entities: [0, count)
+    uint32_t spawned = 0;       // pending spawns: [count, count + spawned)
+    uint32_t destroyed = 0;     // pending destroys in killList
+    EntityHandle killList[Capacity];
+
+    // handle indirection: slot <-> dense index, generation per slot.
+    // Slots [0, slotsUsed) have been issued; freed ones are on freeSlots.
+    uint32_t slotsUsed = 0;
+    uint32_t freeCount = 0;
+    uint32_t freeSlots[Capacity];
+    uint32_t generation[Capacity];
+    uint32_t slotOf[Capacity];  // dense -> slot
+    uint32_t denseOf[Capacity]; // slot -> dense
+
+    template<typename... Qs>
+    static constexpr bool has() { return (ecs_contains<Qs, Cs...>::value && ...); }
+
+    template<typename C>
+    C* column() { return static_cast<ComponentColumn<Capacity, C>&>(*this).data; }
+    template<typename C>
+    const C* column() const { return static_cast<const ComponentColumn<Capacity, C>&>(*this).data; }
+
+    template<typename C>
+    C& get(uint32_t i) { return column<C>()[i]; }
+
+    uint32_t size() const { return count; }
+
+    // Drops every entity; outstanding handles all go stale
+    void clear()
+    {
+        for (uint32_t i = 0; i < count + spawned; ++i) release(slotOf[i]);
+        count = spawned = destroyed = 0;
+    }
+
+    // Reserve an entity; it becomes live at the next flush. -1 when full.
+    int spawn()
+    {
+        if (count + spawned >= Capacity) return -1;
+        uint32_t i = count + spawned++;
+        uint32_t slot;
+        if (freeCount) {
+            slot = freeSlots[--freeCount];
+        } else {
+            slot = slotsUsed++;
+            generation[slot] = 1;
+        }
+        slotOf[i] = slot;
+        denseOf[slot] = i;
+        return (int)i;
+    }
+
+    EntityHandle handle(uint32_t i) const { return EntityHandle{ slotOf[i], generation[slotOf[i]] }; }
+
+    // Dense index of a live (or pending) entity, -1 if the handle is stale
+    int resolve(EntityHandle h) const
+    {
+        if (h.generation == 0 || h.slot >= slotsUsed || generation[h.slot] != h.generation) return -1;
+        return (int)denseOf[h.slot];
+    }
+    bool alive(EntityHandle h) const { return resolve(h) >= 0; }
+
+    // Mark an entity (live or pending) for removal at the next flush;
+    // duplicates are fine. A full list is compacted first: afterwards it
+    // holds each live or pending entity at most once, so a handle that
+    // still does not fit is a duplicate or stale and dropping it is right.
+    void destroy(uint32_t i) { destroy(handle(i)); }
+    void destroy(EntityHandle h)
+    {
+        if (destroyed == Capacity) compactKillList();
+        if (destroyed < Capacity) killList[destroyed++] = h;
+    }
+
+    void flush()
+    {
+        // pending spawns are already in place right after the live range
+        count += spawned;
+        spawned = 0;
+        // handles survive the moves below, so no ordering is needed;
+        // a duplicate resolves to -1 once its first copy is removed
+        for (uint32_t k = 0; k < destroyed; ++k) {
+            int i = resolve(killList[k]);
+            if (i < 0) continue;
+            release(slotOf[i]);
+            moveEntity(count - 1, (uint32_t)i);
+            count--;
+        }
+        destroyed = 0;
+    }
+
+    template<typename... Qs, typename F>
+    void each(F&& fn)
+    {
+        eachImpl<Qs...>(fn, column<Qs>()...);
+    }
+    template<typename... Qs, typename F>
+    void each(F&& fn) const
+    {
+        eachImpl<const Qs...>(fn, column<Qs>()...);
+    }
+
+    // Same, but fn(i, Qs&...) also gets the dense index (for destroy(i))
+    template<typename... Qs, typename F>
+    void eachIndexed(F&& fn)
+    {
+        eachIndexedImpl<Qs...>(fn, column<Qs>()...);
+    }
+
+private:
+    // drop stale and repeated handles; O(n^2), only ever run on a full list
+    void compactKillList()
+    {
+        uint32_t n = 0;
+        for (uint32_t k = 0; k < destroyed; ++k) {
+            EntityHandle h = killList[k];
+            if (resolve(h) < 0) continue;
+            bool seen = false;
+            for (uint32_t j = 0; j < n && !seen; ++j) seen = killList[j] == h;
+            if (!seen) killList[n++] = h;
+        }
+        destroyed = n;
+    }
+
+    void moveEntity(uint32_t from, uint32_t to)
+    {
+        if (from == to) return;
+        ((column<Cs>()[to] = column<Cs>()[from]), ...);
+        slotOf[to] = slotOf[from];
+        denseOf[slotOf[to]] = to;
+    }
+
+    // bump the generation so every handle to this slot goes stale
+    void release(uint32_t slot)
+    {
+        if (++generation[slot] == 0) generation[slot] = 1;
+        freeSlots[freeCount++] = slot;
+    }
+
+    template<typename... Qs, typename F>
+    void eachImpl(F& fn, Qs*... cols) const
+    {
+        const uint32_t n = count;
+        for (uint32_t i = 0; i < n; ++i) fn(cols[i]...);
+    }
+
+    template<typename... Qs, typename F>
+    void eachIndexedImpl(F& fn, Qs*... cols) const
+    {
+        const uint32_t n = count;
+        for (uint32_t i = 0; i < n; ++i) fn(i, cols[i]...);
+    }
+};
+
+// A registry is just its archetypes; each archetype type must be distinct.
+template<typename... As>
+struct Registry : As... {
+    template<typename A>
+    A& get() { return static_cast<A&>(*this); }
+
+    // Run fn(Qs&...) on every live entity of every archetype holding all Qs
+    template<typename... Qs, typename F>
+    void each(F&& fn)
+    {
+        (visit<As, Qs...>(fn), ...);
+    }
+    template<typename... Qs, typename F>
+    void each(F&& fn) const
+    {
+        (visit<As, Qs...>(fn), ...);
+    }
+
+    void flush() { (static_cast<As&>(*this).flush(), ...); }
+    void clear() { (static_cast<As&>(*this).clear(), ...); }
+
+private:
+    template<typename A, typename... Qs, typename F>
+    void visit(F& fn)
+    {
+        if constexpr (A::template has<Qs...>())
+            static_cast<A&>(*this).template each<Qs...>(fn);
+    }
+    template<typename A, typename... Qs, typename F>
+    void visit(F& fn) const
+    {
+        if constexpr (A::template has<Qs...>())
+            static_cast<const A&>(*this).template each<Qs...>(fn);
+    }
+};
+
+#endif
@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------
+//          frame_arena.h — bump allocation for data that dies each frame
+//    FrameArena is a std::pmr::memory_resource over one block reserved up
+//    front: allocate() bumps a pointer, deallocate() is a no-op and
+//    reset() at the start of a frame frees everything at once. Requests
+//    that do not fit go to the upstream resource (the heap) and are
+//    counted as fallbacks, so an undersized arena shows up in the stats
+//    instead of failing.
+//
+//    FrameArenaPair alternates two arenas: begin() hands out the one last
+//    used two frames ago, so whatever was built during the previous frame
+//    stays valid while the next one is built (the frame graph releases
+//    last frame's passes from inside the new frame; a consumer thread can
+//    read frame N while frame N+1 is written, if it is done with N-1
+//    before the producer calls begin()).
+// --------------------------------------------------------------------------
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t capacity, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream), size(capacity)
+    {
+        base = static_cast<char*>(upstream->allocate(capacity, 64));
+    }
+    ~FrameArena() { upstream->deallocate(base, size, 64); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Everything allocated from the arena since the last reset is gone
+    void reset()
+    {
+        used = 0;
+        high = 0;
+        fallbackCount = 0;
+        fallbackSize = 0;
+    }
+
+    size_t capacity() const { return size; }
+    size_t inUse() const { return used; }
+
+    // since the last reset
+    size_t peak() const { return high; }
+    uint32_t fallbacks() const { return fallbackCount; }
+    size_t fallbackBytes() const { return fallbackSize; }
+
+    bool owns(const void* p) const
+    {
+        return static_cast<const char*>(p) >= base && static_cast<const char*>(p) < base + size;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t align) override
+    {
+        uintptr_t start = ((uintptr_t)(base + used) + (align - 1)) & ~(uintptr_t)(align - 1);
+        size_t end = (size_t)(start - (uintptr_t)base) + bytes;
+        if (end <= size) {
+            used = end;
+            if (used > high) high = used;
+            return reinterpret_cast<void*>(start);
+        }
+        fallbackCount++;
+        fallbackSize += bytes;
+        return upstream->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t align) override
+    {
+        if (!owns(p)) upstream->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    std::pmr::memory_resource* upstream;
+    char*    base = nullptr;
+    size_t   size = 0;
+    size_t   used = 0, high = 0;
+    uint32_t fallbackCount = 0;
+    size_t   fallbackSize = 0;
+};
+
+class FrameArenaPair {
+public:
+    explicit FrameArenaPair(size_t capacity) : arenas{ FrameArena(capacity), FrameArena(capacity) } {}
+
+    // Start a frame: reset and return the arena the frame before last used
+    FrameArena& begin()
+    {
+        index ^= 1;
+        arenas[index].reset();
+        return arenas[index];
+    }
+
+    FrameArena& current() { return arenas[index]; }
+    FrameArena& previous() { return arenas[index ^ 1]; }
+
+private:
+    FrameArena arenas[2];
+    int index = 0;
+};
+
+#endif
@@ -0,0 +1,335 @@
+// --------------------------------------------------------------------------
+//            frame_graph.h — declarative render passes + RT pooling
+//    Each frame, passes declare the textures they read and the one target
+//    they write. compile() then
+//      - culls passes whose output nothing (transitively) presents,
+//      - gives every transient texture a lifetime [producer, last reader],
+//      - maps transients onto pooled GL textures, reusing a texture as soon
+//        as its previous occupant is dead (aliasing).
+//    Pooled textures are sized relative to the backbuffer and are dropped
+//    and lazily recreated when the backbuffer size changes.
+//
+//    Persistent textures (createPersistent) keep their contents from frame
+//    to frame for feedback effects: they are found by name, never aliased,
+//    start out cleared and are cleared again when the backbuffer resizes.
+//
+//    Pass callbacks and input lists are copied into the memory resource
+//    given to reset() (the per-frame arena, frame_arena.h) and released at
+//    the next reset(), so building a frame does not touch the heap once
+//    the pass and resource vectors have grown. Pass and texture names are
+//    kept as pointers, not copied, so they must be string literals (a
+//    persistent texture's name is matched again in later frames).
+// --------------------------------------------------------------------------
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+#include "glad.h"
+#include "gpu_timer.h"
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+#include <iostream>
+
+typedef int FGResource;
+const FGResource FG_BACKBUFFER = 0;
+
+struct FGTextureDesc {
+    float  scale = 1.0f;            // of the backbuffer size
+    GLenum format = GL_RGBA16F;
+    bool   depth = false;           // adds a 24-bit depth renderbuffer
+};
+
+class FrameGraph {
+public:
+    GpuTimer timer;
+
+    // per-frame stats, valid after execute()
+    size_t pooledBytes = 0;         // GL memory actually held by the pool (incl. persistent)
+    size_t virtualBytes = 0;        // what it would need without aliasing
+    int    passesRun = 0, passesCulled = 0;
+
+    // ---- building (every frame) ----
+    // Last frame's passes are released into their own memory (which must
+    // still be valid); this frame's are allocated from `frameMemory`
+    void reset(std::pmr::memory_resource* frameMemory = std::pmr::new_delete_resource())
+    {
+        releasePasses();
+        memory = frameMemory;
+        resources.resize(1);        // keep the backbuffer entry
+        resources[0] = Resource();
+        resources[0].name = "backbuffer";
+    }
+
+    FGResource createTexture(const char* name, const FGTextureDesc& desc)
+    {
+        Resource r;
+        r.name = name;
+        r.desc = desc;
+        resources.push_back(r);
+        return (FGResource)resources.size() - 1;
+    }
+
+    // Same, but the texture and its contents outlive the frame
+    FGResource createPersistent(const char* name, const FGTextureDesc& desc)
+    {
+        FGResource r = createTexture(name, desc);
+        resources[r].persistent = true;
+        return r;
+    }
+
+    // Pass writing `output` (a texture from createTexture or FG_BACKBUFFER);
+    // `fn` is called as fn(FrameGraph&)
+    template<typename Fn>
+    void addPass(const char* name, std::initializer_list<FGResource> inputs, FGResource output, Fn fn)
+    {
+        Pass p;
+        p.name = name;
+        p.output = output;
+        p.inputCount = (int)inputs.size();
+        if (p.inputCount) {
+            p.inputs = static_cast<FGResource*>(memory->allocate(sizeof(FGResource) * inputs.size(), alignof(FGResource)));
+            std::copy(inputs.begin(), inputs.end(), p.inputs);
+        }
+        p.fn = new (memory->allocate(sizeof(Fn), alignof(Fn))) Fn(std::move(fn));
+        p.fnSize = sizeof(Fn);
+        p.fnAlign = alignof(Fn);
+        p.run = [](void* f, FrameGraph& g) { (*static_cast<Fn*>(f))(g); };
+        p.destroy = [](void* f) { static_cast<Fn*>(f)->~Fn(); };
+        passes.push_back(p);
+    }
+
+    // ---- inside a pass ----
+    GLuint texture(FGResource r) const { return pool[resources[r].physical].tex; }
+    int width() const { return W; }
+    int height() const { return H; }
+    int outputWidth() const { return curW; }
+    int outputHeight() const { return curH; }
+
+    // ---- compile + run ----
+    void execute(int backbufferW, int backbufferH)
+    {
+        if (backbufferW != W || backbufferH != H) {
+            // lazily reallocated below as passes need targets
+            releasePool();
+            W = backbufferW;
+            H = backbufferH;
+        }
+        compile();
+
+        timer.beginFrame();
+        passesRun = 0;
+        for (size_t i = 0; i < passes.size(); ++i) {
+            Pass& p = passes[i];
+            if (p.culled) continue;
+            if (p.output == FG_BACKBUFFER) {
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                curW = W; curH = H;
+            } else {
+                Physical& t = pool[resources[p.output].physical];
+                glBindFramebuffer(GL_FRAMEBUFFER, t.fbo);
+                curW = t.w; curH = t.h;
+            }
+            glViewport(0, 0, curW, curH);
+            timer.begin(p.name);
+            p.run(p.fn, *this);
+            timer.end();
+            passesRun++;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, W, H);
+    }
+
+    void destroyGL()
+    {
+        releasePasses();
+        releasePool();
+        timer.destroyGL();
+    }
+
+private:
+    struct Resource {
+        const char* name = nullptr;
+        FGTextureDesc desc;
+        int producer = -1, lastUse = -1;
+        int physical = -1;
+        bool persistent = false;
+    };
+    struct Pass {
+        const char* name;
+        FGResource* inputs = nullptr;   // in `memory`
+        int         inputCount = 0;
+        FGResource  output;
+        void*       fn;                 // the callable, in `memory`
+        size_t      fnSize, fnAlign;
+        void (*run)(void*, FrameGraph&);
+        void (*destroy)(void*);
+        bool culled = false;
+    };
+    struct Physical {
+        GLuint tex = 0, fbo = 0, depthRB = 0;
+        int w = 0, h = 0;
+        GLenum format = 0;
+        bool depth = false;
+        int busyUntil = -1;     // last pass index of the current occupant
+        const char* persistent = nullptr; // owner name; never aliased when set
+    };
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    std::vector<Physical> pool;
+    std::pmr::memory_resource* memory = std::pmr::new_delete_resource();
+    int W = 0, H = 0;
+    int curW = 0, curH = 0;
+
+    static size_t bytesPerPixel(GLenum format, bool depth)
+    {
+        size_t d = depth ? 4 : 0;
+        switch (format) {
+        case GL_RGBA16F: return 8 + d;
+        case GL_RGBA32F: return 16 + d;
+        case GL_R11F_G11F_B10F: return 4 + d;
+        default: return 4 + d;
+        }
+    }
+
+    void sizeFor(const FGTextureDesc& d, int& w, int& h) const
+    {
+        w = (int)(W * d.scale); if (w < 1) w = 1;
+        h = (int)(H * d.scale); if (h < 1) h = 1;
+    }
+
+    void compile()
+    {
+        // producers; a resource written twice keeps the last writer
+        for (auto& r : resources) { r.producer = -1; r.lastUse = -1; r.physical = -1; }
+        for (size_t i = 0; i < passes.size(); ++i) {
+            passes[i].culled = true;
+            resources[passes[i].output].producer = (int)i;
+        }
+
+        // cull: walk back from the backbuffer writers
+        std::pmr::vector<int> stack(memory);
+        stack.reserve(passes.size());
+        for (size_t i = 0; i < passes.size(); ++i)
+            if (passes[i].output == FG_BACKBUFFER) stack.push_back((int)i);
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+            if (!passes[i].culled) continue;
+            passes[i].culled = false;
+            for (int k = 0; k < passes[i].inputCount; ++k) {
+                FGResource in = passes[i].inputs[k];
+                if (resources[in].producer >= 0) stack.push_back(resources[in].producer);
+            }
+        }
+        passesCulled = 0;
+        for (auto& p : passes) passesCulled += p.culled ? 1 : 0;
+
+        // lifetimes over surviving passes
+        for (size_t i = 0; i < passes.size(); ++i) {
+            if (passes[i].culled) continue;
+            for (int k = 0; k < passes[i].inputCount; ++k) resources[passes[i].inputs[k]].lastUse = (int)i;
+            Resource& out = resources[passes[i].output];
+            if (out.lastUse < (int)i) out.lastUse = (int)i;
+        }
+
+        // assign pooled textures in pass order: outputs first, so a pass
+        // never aliases its output with one of its own inputs
+        for (auto& t : pool) t.busyUntil = -1;
+        virtualBytes = 0;
+        for (auto& r : resources)
+            if (r.persistent) bindPersistent(r);
+        for (size_t i = 0; i < passes.size(); ++i) {
+            if (passes[i].culled || passes[i].output == FG_BACKBUFFER) continue;
+            Resource& r = resources[passes[i].output];
+            if (r.physical >= 0) continue;
+            int w, h;
+            sizeFor(r.desc, w, h);
+            virtualBytes += (size_t)w * h * bytesPerPixel(r.desc.format, r.desc.depth);
+            for (size_t k = 0; k < pool.size() && r.physical < 0; ++k) {
+                Physical& t = pool[k];
+                if (!t.persistent && t.busyUntil < (int)i && t.w == w && t.h == h &&
+                    t.format == r.desc.format && t.depth == r.desc.depth)
+                    r.physical = (int)k;
+            }
+            if (r.physical < 0) {
+                pool.push_back(makePhysical(w, h, r.desc.format, r.desc.depth));
+                r.physical = (int)pool.size() - 1;
+            }
+            pool[r.physical].busyUntil = r.lastUse;
+        }
+        pooledBytes = 0;
+        for (auto& t : pool) pooledBytes += (size_t)t.w * t.h * bytesPerPixel(t.format, t.depth);
+    }
+
+    void bindPersistent(Resource& r)
+    {
+        int w, h;
+        sizeFor(r.desc, w, h);
+        virtualBytes += (size_t)w * h * bytesPerPixel(r.desc.format, r.desc.depth);
+        for (size_t k = 0; k < pool.size(); ++k)
+            if (pool[k].persistent && strcmp(pool[k].persistent, r.name) == 0) { r.physical = (int)k; return; }
+        Physical t = makePhysical(w, h, r.desc.format, r.desc.depth);
+        t.persistent = r.name;
+        glBindFramebuffer(GL_FRAMEBUFFER, t.fbo);
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        pool.push_back(t);
+        r.physical = (int)pool.size() - 1;
+    }
+
+    static Physical makePhysical(int w, int h, GLenum format, bool depth)
+    {
+        Physical t;
+        t.w = w; t.h = h; t.format = format; t.depth = depth;
+        glGenTextures(1, &t.tex);
+        glBindTexture(GL_TEXTURE_2D, t.tex);
+        GLenum type = (format == GL_RGBA16F || format == GL_RGBA32F || format == GL_R11F_G11F_B10F)
+                    ? GL_FLOAT : GL_UNSIGNED_BYTE;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0, GL_RGBA, type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glGenFramebuffers(1, &t.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, t.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t.tex, 0);
+        if (depth) {
+            glGenRenderbuffers(1, &t.depthRB);
+            glBindRenderbuffer(GL_RENDERBUFFER, t.depthRB);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, t.depthRB);
+        }
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            std::cout << "ERROR::FRAMEBUFFER:: frame graph target incomplete" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return t;
+    }
+
+    void releasePasses()
+    {
+        for (Pass& p : passes) {
+            p.destroy(p.fn);
+            memory->deallocate(p.fn, p.fnSize, p.fnAlign);
+            if (p.inputs) memory->deallocate(p.inputs, sizeof(FGResource) * p.inputCount, alignof(FGResource));
+        }
+        passes.clear();
+    }
+
+    void releasePool()
+    {
+        for (auto& t : pool) {
+            glDeleteFramebuffers(1, &t.fbo);
+            glDeleteTextures(1, &t.tex);
+            if (t.depthRB) glDeleteRenderbuffers(1, &t.depthRB);
+        }
+        pool.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,294 @@
+// --------------------------------------------------------------------------
+//           game_state.h — deterministic fixed-tick game simulation
+//    Everything a match needs lives in GameState: players, ghosts,
+//    particles, lives and the RNG. simStep() advances it by exactly one
+//    SIM_DT tick from the players' inputs and nothing else (no wall clock,
+//    no rand(), no libm trig), so the same inputs give the same state on
+//    every peer built with the same float settings (no FMA contraction,
+//    see SIM_FLAGS in the Makefile). That is what rollback (rollback.h)
+//    restores and replays.
+//
+//    One player is the classic game; two is versus: shared lives, each
+//    player scores their own kills.
+// --------------------------------------------------------------------------
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "components.h"
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// world units are NDC-like in [-1,1]
+const float PLAYER_W = 0.18f;
+const float PLAYER_H = 0.06f;
+const float PLAYER_Y = -0.85f;
+const float PLAYER_SPEED = 1.7f;
+
+const float BULLET_W = 0.02f;
+const float BULLET_H = 0.06f;
+const float BULLET_SPEED = 2.6f;     // slightly faster for snappier feel
+const float SHOOT_COOLDOWN = 0.22f;  // a touch tighter
+
+const float GHOST_W = 0.10f;
+const float GHOST_H = 0.10f;
+const float GHOST_SPEED_MIN = 0.35f;
+const float GHOST_SPEED_MAX = 0.75f;
+const float GHOST_DROP = 0.04f;
+
+const float SIM_DT = 1.0f / 60.0f;
+const int   MAX_PLAYERS = 2;
+
+// One byte of buttons per player per tick
+typedef uint8_t PlayerInput;
+enum InputBits : uint8_t {
+    INPUT_LEFT    = 1,
+    INPUT_RIGHT   = 2,
+    INPUT_FIRE    = 4,
+    INPUT_RESTART = 8
+};
+
+// Raised during a tick, for effects (shake) on the presentation side
+enum SimEvents : uint32_t {
+    EVENT_LIFE_LOST = 1,
+    EVENT_KILL      = 2,
+    EVENT_SHOT      = 4
+};
+
+// xorshift32: tiny, fast and identical everywhere
+struct SimRng {
+    uint32_t s;
+
+    uint32_t next()
+    {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+    float range(float a, float b) { return a + (b - a) * (float)(next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+struct PlayerState {
+    float   x;
+    float   shootTimer;
+    int32_t bulletActive;
+    float   bulletX, bulletY;
+    int32_t score;
+};
+
+struct GameState {
+    uint32_t tick;
+    int32_t  numPlayers;
+    int32_t  lives;
+    int32_t  gameOver;
+    uint32_t events;        // SimEvents of the last simStep
+    SimRng   rng;
+    PlayerState players[MAX_PLAYERS];
+    GameWorld world;
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "snapshots copy GameState as bytes");
+
+// ---------------------------------------------------------------- setup ----
+inline void simSpawnWave(GameState& g, int n, float speedScale = 1.0f)
+{
+    GhostArchetype& ghosts = g.world.get<GhostArchetype>();
+    ghosts.clear();
+    n = std::min(n, MAX_GHOSTS);
+    for (int i = 0; i < n; ++i) {
+        int e = ghosts.spawn();
+        ghosts.get<GhostX>(e).v = g.rng.range(-0.85f, 0.85f);
+        ghosts.get<GhostY>(e).v = g.rng.range(0.20f, 0.90f);
+        float sp = g.rng.range(GHOST_SPEED_MIN, GHOST_SPEED_MAX) * speedScale;
+        ghosts.get<GhostVX>(e).v = (g.rng.next() & 1) ? sp : -sp;
+        ghosts.get<GhostPhase>(e).v = g.rng.range(0.0f, 6.28318f);
+    }
+    ghosts.flush();
+}
+
+inline void simSpawnExplosion(GameState& g, float x, float y, int puff)
+{
+    ParticleArchetype& particles = g.world.get<ParticleArchetype>();
+    for (int i = 0; i < puff; ++i) {
+        int e = particles.spawn();
+        if (e < 0) break;   // pool full: drop the rest of the burst
+        float ang = g.rng.range(0.0f, 6.28318f);
+        float spd = g.rng.range(0.25f, 1.0f);
+        particles.get<Position>(e) = Position{ x, y };
+        // ghostSin instead of libm, whose sin differs between platforms; the
+        // Makefile also turns off FMA contraction (SIM_FLAGS) for the same bits
+        particles.get<Velocity>(e) = Velocity{ ghostSin(ang + 1.57079633f) * spd, ghostSin(ang) * spd };
+        particles.get<ParticleLife>(e) = ParticleLife{ 1.0f, g.rng.range(0.012f, 0.028f) };
+    }
+}
+
+// New match; the state is zeroed first so padding is deterministic too
+inline void gameReset(GameState& g, int numPlayers, uint32_t seed)
+{
+    memset(static_cast<void*>(&g), 0, sizeof(g));
+    g.numPlayers = std::max(1, std::min(numPlayers, MAX_PLAYERS));
+    g.lives = 3;
+    g.rng.s = seed ? seed : 0x9e3779b9u;
+    for (int p = 0; p < g.numPlayers; ++p) {
+        PlayerState& pl = g.players[p];
+        pl.x = g.numPlayers == 1 ? 0.0f : (p == 0 ? -0.4f : 0.4f);
+        pl.bulletY = -1.5f;
+    }
+    simSpawnWave(g, 6);
+}
+
+// ----------------------------------------------------------------- step ----
+inline void simStep(GameState& g, const PlayerInput* inputs)
+{
+    const float dt = SIM_DT;
+    g.events = 0;
+    g.tick++;
+
+    // restart keeps the RNG stream going, so peers stay in lockstep
+    if (g.gameOver) {
+        for (int p = 0; p < g.numPlayers; ++p) {
+            if (inputs[p] & INPUT_RESTART) {
+                uint32_t tick = g.tick;
+                gameReset(g, g.numPlayers, g.rng.next());
+                g.tick = tick;
+                break;
+            }
+        }
+        return;
+    }
+
+    // players: move, clamp, shoot (single bullet each, basic cooldown)
+    for (int p = 0; p < g.numPlayers; ++p) {
+        PlayerState& pl = g.players[p];
+        pl.shootTimer += dt;
+        float move = PLAYER_SPEED * dt;
+        if (inputs[p] & INPUT_LEFT)  pl.x -= move;
+        if (inputs[p] & INPUT_RIGHT) pl.x += move;
+        if (pl.x + PLAYER_W*0.5f > 1.0f)  pl.x = 1.0f - PLAYER_W*0.5f;
+        if (pl.x - PLAYER_W*0.5f < -1.0f) pl.x = -1.0f + PLAYER_W*0.5f;
+        if ((inputs[p] & INPUT_FIRE) && !pl.bulletActive && pl.shootTimer >= SHOOT_COOLDOWN) {
+            pl.bulletActive = 1;
+            pl.bulletX = pl.x;
+            pl.bulletY = PLAYER_Y + PLAYER_H*0.5f + BULLET_H*0.6f;
+            pl.shootTimer = 0.0f;
+            g.events |= EVENT_SHOT;
+        }
+        if (pl.bulletActive) {
+            pl.bulletY += BULLET_SPEED * dt;
+            if (pl.bulletY > 1.1f) pl.bulletActive = 0;
+        }
+    }
+
+    // Ghosts: vectorized move/bounce, then only the ghosts flagged in the
+    // masks take the slow path (kills deferred to flush). The kernel tests
+    // player 0's bullet; player 1's is tested against the moved ghosts.
+    GhostArchetype& ghosts = g.world.get<GhostArchetype>();
+    float* gx = floatColumn<GhostX>(ghosts);
+    float* gy = floatColumn<GhostY>(ghosts);
+    float* gvx = floatColumn<GhostVX>(ghosts);
+    GhostKernelParams kp;
+    kp.dt = dt;
+    kp.time = (float)g.tick * dt;
+    kp.halfW = GHOST_W * 0.5f;
+    kp.drop = GHOST_DROP;
+    kp.lineY = PLAYER_Y + PLAYER_H * 0.5f + GHOST_H * 0.5f;
+    kp.bulletActive = g.players[0].bulletActive;
+    kp.bulletX = g.players[0].bulletX;
+    kp.bulletY = g.players[0].bulletY;
+    kp.hitX = (BULLET_W + GHOST_W) * 0.5f;
+    kp.hitY = (BULLET_H + GHOST_H) * 0.5f;
+    const uint32_t n = ghosts.size();
+    uint32_t lineMask[ghostMaskWords(MAX_GHOSTS)], hitMask[ghostMaskWords(MAX_GHOSTS)];
+    uint32_t dead[ghostMaskWords(MAX_GHOSTS)] = {};
+    bool any = ghostKernel(gx, gy, gvx, floatColumn<GhostPhase>(ghosts), n, kp, lineMask, hitMask);
+
+    auto kill = [&](uint32_t i, PlayerState& shooter) {
+        dead[i >> 5] |= 1u << (i & 31);
+        ghosts.destroy(i);
+        shooter.bulletActive = 0;
+        shooter.score += 10;
+        // small global speed-up as difficulty ramp
+        for (uint32_t j = 0; j < n; ++j) gvx[j] *= 1.035f;
+        simSpawnExplosion(g, gx[i], gy[i], 24);
+        g.events |= EVENT_KILL;
+    };
+
+    if (any) {
+        for (uint32_t w = 0; w < ghostMaskWords(n); ++w) {
+            // reached player line?
+            for (uint32_t bits = lineMask[w]; bits; bits &= bits - 1) {
+                uint32_t i = w * 32 + ctz32(bits);
+                dead[w] |= 1u << (i & 31);
+                ghosts.destroy(i);
+                if (--g.lives <= 0) g.gameOver = 1;
+                g.events |= EVENT_LIFE_LOST;
+            }
+            // bullet collision: first ghost hit takes the bullet
+            for (uint32_t bits = hitMask[w] & ~lineMask[w]; bits && g.players[0].bulletActive; bits &= bits - 1)
+                kill(w * 32 + ctz32(bits), g.players[0]);
+        }
+    }
+    if (g.numPlayers > 1 && g.players[1].bulletActive) {
+        PlayerState& pl = g.players[1];
+        for (uint32_t i = 0; i < n && pl.bulletActive; ++i) {
+            if (dead[i >> 5] & (1u << (i & 31))) continue;
+            if (std::fabs(pl.bulletX - gx[i]) < kp.hitX && std::fabs(pl.bulletY - gy[i]) < kp.hitY)
+                kill(i, pl);
+        }
+    }
+
+    // particles (spawned this tick start moving next tick)
+    ParticleArchetype& particles = g.world.get<ParticleArchetype>();
+    particles.eachIndexed<Position, Velocity, ParticleLife>(
+        [&](uint32_t i, Position& p, Velocity& v, ParticleLife& l) {
+            l.life -= dt * 1.4f;
+            p.x += v.x * dt;
+            p.y += v.y * dt;
+            float drag = 1.0f - 0.9f * dt; // gentle drag
+            v.x *= drag;
+            v.y *= drag;
+            if (l.life <= 0.0f) particles.destroy(i);
+        });
+
+    // apply deferred kills/spawns
+    g.world.flush();
+
+    // all ghosts cleared -> next wave
+    if (!g.gameOver && ghosts.size() == 0) {
+        int score = 0;
+        for (int p = 0; p < g.numPlayers; ++p) score += g.players[p].score;
+        int nextCount = std::min(MAX_GHOSTS, 4 + (score / 20)); // gradually increase count
+        float speedScale = 1.0f + (score / 100.0f);
+        simSpawnWave(g, nextCount, speedScale);
+    }
+}
+
+// FNV-1a over the live simulation data (every column of the live
+// entities, not the unused pool slots), for desync checks between peers
+inline uint64_t gameChecksum(const GameState& g)
+{
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* p, size_t n) {
+        const unsigned char* b = (const unsigned char*)p;
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ull; }
+    };
+    mix(&g.tick, sizeof(g.tick));
+    mix(&g.numPlayers, sizeof(g.numPlayers));
+    mix(&g.lives, sizeof(g.lives));
+    mix(&g.gameOver, sizeof(g.gameOver));
+    mix(&g.rng, sizeof(g.rng));
+    mix(g.players, sizeof(g.players));
+    const GhostArchetype& ghosts = g.world;
+    mix(ghosts.column<GhostX>(), ghosts.count * sizeof(GhostX));
+    mix(ghosts.column<GhostY>(), ghosts.count * sizeof(GhostY));
+    mix(ghosts.column<GhostVX>(), ghosts.count * sizeof(GhostVX));
+    mix(ghosts.column<GhostPhase>(), ghosts.count * sizeof(GhostPhase));
+    const ParticleArchetype& parts = g.world;
+    mix(parts.column<Position>(), parts.count * sizeof(Position));
+    mix(parts.column<Velocity>(), parts.count * sizeof(Velocity));
+    mix(parts.column<ParticleLife>(), parts.count * sizeof(ParticleLife));
+    return h;
+}
+
+#endif
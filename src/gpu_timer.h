@@ -0,0 +1,85 @@
+// --------------------------------------------------------------------------
+//              gpu_timer.h — per-pass GPU timings without stalls
+//    GL_TIME_ELAPSED queries, one per named pass, in a ring of frames; the
+//    results read back are from FRAMES-1 frames ago, which the GPU has
+//    long finished, so nothing ever waits on a query.
+// --------------------------------------------------------------------------
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include "glad.h"
+#include <vector>
+
+class GpuTimer {
+public:
+    static const int FRAMES = 3;
+
+    // ms for each pass, smoothed; valid after a few frames
+    struct Pass { const char* name; double ms = 0.0; };
+    std::vector<Pass> passes;
+
+    void beginFrame()
+    {
+        frame = (frame + 1) % FRAMES;
+        cursor = 0;
+    }
+
+    // Time everything until end(). Passes are matched by call order; the
+    // name is kept as a pointer (a literal), so this never allocates once
+    // every pass has been seen.
+    void begin(const char* name)
+    {
+        if (cursor == (int)passes.size()) {
+            passes.push_back(Pass{ name, 0.0 });
+            Slot s;
+            glGenQueries(FRAMES, s.query);
+            slots.push_back(s);
+        }
+        passes[cursor].name = name;
+        Slot& s = slots[cursor];
+        // collect the oldest result in this slot before reusing its query
+        if (s.issued[frame]) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(s.query[frame], GL_QUERY_RESULT, &ns);
+            passes[cursor].ms = passes[cursor].ms * 0.9 + (ns * 1e-6) * 0.1;
+        }
+        glBeginQuery(GL_TIME_ELAPSED, s.query[frame]);
+        s.issued[frame] = true;
+    }
+
+    void end()
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        cursor++;
+    }
+
+    // number of passes timed in the current frame (earlier frames may have had more)
+    int active() const { return cursor; }
+
+    // sum over the passes timed this frame; entries past active() belong to
+    // passes that no longer run (bloom switched off) and keep stale times
+    double total() const
+    {
+        double t = 0.0;
+        for (int i = 0; i < cursor; ++i) t += passes[i].ms;
+        return t;
+    }
+
+    void destroyGL()
+    {
+        for (auto& s : slots) glDeleteQueries(FRAMES, s.query);
+        slots.clear();
+        passes.clear();
+    }
+
+private:
+    struct Slot {
+        GLuint query[FRAMES];
+        bool issued[FRAMES] = {};
+    };
+    std::vector<Slot> slots;
+    int frame = 0;
+    int cursor = 0;
+};
+
+#endif
@@ -0,0 +1,79 @@
+// --------------------------------------------------------------------------
+//            input_queue.h — timestamped key events, consumed per tick
+//    GLFW key callbacks push (time, key, down) events into a lock-free
+//    queue instead of the game polling glfwGetKey once per frame. Each
+//    simulation tick then takes only the events that happened before its
+//    end time, so
+//      - a tap shorter than a frame still counts: a key pressed during
+//        a tick is down for that tick even if released before it ends,
+//      - input lands in the tick it happened in, not in whichever frame
+//        happened to poll it.
+//    Consumed presses keep their timestamps until the frame showing them
+//    is presented, for input-to-present latency measurement.
+// --------------------------------------------------------------------------
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include "spsc_queue.h"
+#include <cstdint>
+#include <cstring>
+
+struct InputEvent {
+    double  time;           // glfwGetTime() in the callback
+    int16_t key;
+    uint8_t down;
+};
+
+typedef SpscQueue<InputEvent, 256> InputEventQueue;
+
+class KeyState {
+public:
+    static const int KEY_SLOTS = 512;       // > GLFW_KEY_LAST
+    static const int MAX_PENDING = 32;
+
+    KeyState()
+    {
+        memset(held, 0, sizeof(held));
+        memset(tapped, 0, sizeof(tapped));
+    }
+
+    // Apply every queued event that happened before `until`
+    void consume(InputEventQueue& q, double until)
+    {
+        while (const InputEvent* e = q.peek()) {
+            if (e->time > until) break;
+            if (e->key >= 0 && e->key < KEY_SLOTS) {
+                held[e->key] = e->down;
+                if (e->down) {
+                    tapped[e->key] = 1;
+                    if (pendingCount < MAX_PENDING) pending[pendingCount++] = e->time;
+                }
+            }
+            InputEvent done;
+            q.pop(done);
+        }
+    }
+
+    // down now, or pressed at some point during the current tick
+    bool down(int key) const { return key >= 0 && key < KEY_SLOTS && (held[key] || tapped[key]); }
+
+    // the tick used the input: forget taps, keep held keys
+    void endTick() { memset(tapped, 0, sizeof(tapped)); }
+
+    // press times consumed by ticks since the last call (for latency)
+    int takePending(double* out)
+    {
+        int n = pendingCount;
+        memcpy(out, pending, sizeof(double) * n);
+        pendingCount = 0;
+        return n;
+    }
+
+private:
+    uint8_t held[KEY_SLOTS];
+    uint8_t tapped[KEY_SLOTS];
+    double  pending[MAX_PENDING];
+    int     pendingCount = 0;
+};
+
+#endif
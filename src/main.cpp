@@ -8,132 +8,121 @@
 #include "glm/glm/glm.hpp"
 #include "glm/glm/gtc/matrix_transform.hpp"
 #include "glm/glm/gtc/type_ptr.hpp"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#undef STB_IMAGE_IMPLEMENTATION   // later includes only want the declarations
+#include "rect_batch.h"
+#include "atlas.h"
+#include "asset_loader.h"
+#include "shader_m.h"
+#include "shader_watch.h"
+#include "components.h"
+#include "game_state.h"
+#include "rollback.h"
+#include "snapshot.h"
+#include "autopilot.h"
+#include "soak.h"
+#include "agent_channel.h"
+#include "audio_mixer.h"
+#include "input_queue.h"
+#include "triple_buffer.h"
+#include "frame_arena.h"
+#include "starfield.h"
+#include "bloom.h"
+#include "trails.h"
+#include "render_layers.h"
+#include <functional>
 #include <iostream>
 #include <string>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <new>
+#include <thread>
 
 // Function declarations and shared data
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow *window, float deltaTime);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void processInput(GLFWwindow *window);
+enum KeySet { KEYS_ALL, KEYS_LEFT_HAND, KEYS_RIGHT_HAND };
+PlayerInput readInput(KeySet keys);
 
 // =====================[ Shaders ]=====================
-// Vertex: send through transform and also pass transformed position to fragment
-const char* vertexShaderSource = R"GLSL(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-uniform mat4 transform;
-out vec3 vWorldPos;   // position after transform (NDC-ish during our simple pipeline)
-void main() {
-    vec4 p = transform * vec4(aPos, 1.0);
-    vWorldPos = p.xyz;
-    gl_Position = p;
-}
-)GLSL";
-
-// Fragment: two modes — solid color, or vertical gradient
-// Also supports a "glow" multiplier (for pulsing ghosts/objects)
-const char *fragmentShaderSource = R"GLSL(
-#version 330 core
-out vec4 FragColor;
-in vec3 vWorldPos;
-
-uniform vec4  ourColor;
-uniform int   useGradient;
-uniform vec3  gradTop;
-uniform vec3  gradBottom;
-uniform float glow;        // 1.0 = normal, >1 brighter, <1 dimmer
-
-void main() {
-    vec3 color;
-    if (useGradient == 1) {
-        // Map NDC y (-1..1) -> 0..1
-        float t = clamp(vWorldPos.y * 0.5 + 0.5, 0.0, 1.0);
-        color = mix(gradBottom, gradTop, t);
-        FragColor = vec4(color, 1.0);
-    } else {
-        color = ourColor.rgb * glow;
-        FragColor = vec4(color, ourColor.a);
-    }
-}
-)GLSL";
+// Sources live in resources/shaders and are hot-reloaded when saved
+const char* SHADER_DIR = "resources/shaders";
 
 // =====================[ Constants ]===================
 const unsigned int SCR_WIDTH  = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-// world units are NDC-like in [-1,1]
-const float PLAYER_W = 0.18f;
-const float PLAYER_H = 0.06f;
-const float PLAYER_Y = -0.85f;
-
-const float BULLET_W = 0.02f;
-const float BULLET_H = 0.06f;
-const float BULLET_SPEED = 2.6f;     // slightly faster for snappier feel
-const float SHOOT_COOLDOWN = 0.22f;  // a touch tighter
-
-const int   MAX_GHOSTS = 8;
-const float GHOST_W = 0.10f;
-const float GHOST_H = 0.10f;
-const float GHOST_SPEED_MIN = 0.35f;
-const float GHOST_SPEED_MAX = 0.75f;
-const float GHOST_DROP = 0.04f;
-
 const glm::vec3 COLOR_BG_TOP     = glm::vec3(0.12f, 0.00f, 0.20f);
 const glm::vec3 COLOR_BG_BOTTOM  = glm::vec3(0.02f, 0.02f, 0.08f);
 const glm::vec3 COLOR_PLAYER     = glm::vec3(0.10f, 0.90f, 0.90f);
+const glm::vec3 COLOR_PLAYER2    = glm::vec3(1.00f, 0.55f, 0.15f);
 const glm::vec3 COLOR_BULLET     = glm::vec3(1.00f, 0.95f, 0.30f);
 const glm::vec3 COLOR_GHOST      = glm::vec3(0.90f, 0.10f, 0.95f);
 const glm::vec3 COLOR_EYES       = glm::vec3(1.00f, 1.00f, 1.00f);
 const glm::vec3 COLOR_DIVIDER    = glm::vec3(0.28f, 0.28f, 0.32f);
 
 // =====================[ Globals ]=====================
-float playerX = 0.0f;
-float playerSpeed = 1.7f;
-
-bool  bulletActive = false;
-float bulletX = 0.0f, bulletY = -1.5f;
-float shootTimer = 0.0f;
-
-int   score = 0;
-int   lives = 3;
-bool  gameOver = false;
-
 float timeNow = 0.0f;
 
 // Screen shake on life loss
 float shakeTimer = 0.0f;
 float shakeStrength = 0.0f;
 
-struct Ghost {
-    float x, y;
-    float vx;   // horizontal velocity (sign gives direction)
-    bool  alive;
-    float phase; // per-ghost sine wave offset
-};
-std::vector<Ghost> ghosts;
-
-struct Particle {
-    glm::vec2 pos;
-    glm::vec2 vel;
-    float life;     // 0..1
-    float size;
+// Single player runs the simulation directly; versus runs it inside one
+// rollback session per local player (see rollback.h)
+enum NetMode { NET_OFF, NET_LOOPBACK, NET_UDP };
+static NetMode netMode = NET_OFF;
+static GameState game;
+static RollbackSession sessions[2];     // [0] is presented
+static LoopbackNetwork loopback;        // --versus: both players on one keyboard
+static UdpTransport udp;                // --versus-udp: one player per machine
+const uint32_t REWIND_TICKS = 128;      // ~2 s of single-player history
+static SnapshotRing<GameState, REWIND_TICKS> history;   // BACKSPACE rewinds
+static bool autopilot = false;          // --autopilot: bots play, keyboard ignored
+static Autopilot bots[2] = { Autopilot(0), Autopilot(1) };  // per session slot
+static AgentChannel agent;              // --agent NAME: an external process plays slot 0
+static AudioMixer audio;                // sound effects, mixed on their own thread
+static NullAudioBackend audioNull;      // default output: no sound device needed
+static WavAudioBackend audioWav;        // --audio-wav FILE
+
+// Gameplay keys arrive through key_callback and are consumed per tick
+static InputEventQueue inputEvents;
+static KeyState keyState;
+static bool lateLatch = false;          // --late-latch: input and snapshot taken right before drawing
+static bool measureLatency = false;     // --measure-latency: key press -> present
+static FrameHistogram inputLatency;
+
+// The simulation runs on its own thread (simThreadMain) and hands the
+// render thread an immutable copy of the presented state after each batch
+// of ticks. Only the render thread touches GL and the window.
+struct RenderSnapshot {
+    GameState state;
+    uint64_t  ticks;                    // sim ticks run when it was taken
 };
-std::vector<Particle> particles;
-
-// Parallax stars
-struct Star {
-    glm::vec2 pos;
-    float speed; // vertical speed
-    float size;
-    float alpha;
+struct PressStamp {
+    double   time;                      // key callback time
+    uint64_t ticks;                     // first snapshot that includes it
 };
-std::vector<Star> stars;
-
-const int STAR_COUNT = 120;
+static TripleBuffer<RenderSnapshot> renderSnapshots;
+static std::atomic<uint32_t> simEvents{ 0 };   // EVENT_* not yet seen by the render thread
+static SpscQueue<PressStamp, 64> simPresses;    // --measure-latency only
+static std::atomic<bool> simRunning{ false };
+static std::atomic<uint64_t> simBusyNs{ 0 };    // since the last thread report
+static std::atomic<uint64_t> simTicksRun{ 0 };
+
+// Per-frame transient memory on the render thread: the window title and
+// the frame graph's passes. Two arenas, so last frame's passes are still
+// intact when frameGraph.reset() releases them.
+const size_t FRAME_ARENA_BYTES = 64 * 1024;
+static FrameArenaPair frameArenas(FRAME_ARENA_BYTES);
+Starfield starfield;
 
 const char* windowBase = "Ghost Busters";
 
@@ -145,59 +134,147 @@ static inline bool aabbHit(float ax, float ay, float aw, float ah,
            std::fabs(ay - by) * 2.0f < (ah + bh);
 }
 
-// random helper
+// random helper (presentation only; the simulation has its own RNG)
 static inline float frand(float a, float b) {
     return a + (b - a) * (float)(rand() % 10000) / 10000.0f;
 }
 
-static void spawnWave(int n, float speedScale = 1.0f) {
-    ghosts.clear();
-    n = std::min(n, MAX_GHOSTS);
-    for (int i = 0; i < n; ++i) {
-        Ghost g;
-        g.x = frand(-0.85f, 0.85f);
-        g.y = frand(0.20f, 0.90f);
-        float sp = frand(GHOST_SPEED_MIN, GHOST_SPEED_MAX) * speedScale;
-        g.vx = (rand() % 2 ? sp : -sp);
-        g.alive = true;
-        g.phase = frand(0.0f, 6.28318f);
-        ghosts.push_back(g);
-    }
+static const GameState& presentedState() {
+    return netMode == NET_OFF ? game : sessions[0].presented();
 }
 
-static void initStars() {
-    stars.clear();
-    stars.reserve(STAR_COUNT);
-    for (int i=0;i<STAR_COUNT;++i) {
-        Star s;
-        s.pos = glm::vec2(frand(-1.0f, 1.0f), frand(-1.0f, 1.0f));
-        float layer = frand(0.0f, 1.0f);
-        s.speed = 0.05f + layer * 0.25f;  // parallax
-        s.size = 0.004f + layer * 0.01f;
-        s.alpha = 0.5f + layer * 0.5f;
-        stars.push_back(s);
-    }
+// =====================[ Allocation counting ]=====================
+// Every global new/delete is counted for the soak report (soak.h)
+SOAK_NOINLINE void* operator new(size_t size)
+{
+    soakAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
 }
-
-static void resetGame() {
-    score = 0;
-    lives = 3;
-    gameOver = false;
-    playerX = 0.0f;
-    bulletActive = false;
-    shootTimer = 0.0f;
-    particles.clear();
-    initStars();
-    spawnWave(6);
+SOAK_NOINLINE void operator delete(void* p) noexcept
+{
+    if (p) soakFrees.fetch_add(1, std::memory_order_relaxed);
+    free(p);
 }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
 
 // ============ OpenGL helpers =============
-static unsigned int shaderProgram;
-static int uTransformLoc, uColorLoc, uUseGradientLoc, uGradTopLoc, uGradBottomLoc, uGlowLoc;
+static Shader* rectShader;
+static ShaderWatcher shaderWatcher;
+static Bloom bloom;                     // 'B' cycles quality
+static FrameGraph frameGraph;
+static Trails trails;
+static RectBatch trailBatch;            // bullets, particles, fast ghosts
+const float TRAIL_GHOST_SPEED = 0.8f;   // |vx| above which ghosts leave a trail
+static int starCount = 120;             // --stars N; cost is GPU-only
+static int uViewOffsetLoc, uUseGradientLoc, uGradTopLoc, uGradBottomLoc, uTimeLoc, uDepthLoc;
+static RenderLayers layers;             // declared back to front in main()
+static int layerBackground, layerStars, layerTrails, layerWorld, layerShapes, layerParticles;
+static float viewX = 0.0f, viewY = 0.0f; // screen shake offset this frame
+static FGResource trailBuffer;
+static Atlas spriteAtlas;
+static AssetLoader assets;
+static AssetPack assetPack;             // build/assets.pak, if `make pack` was run
+static AssetHandle spriteGhost, spritePlayer;
+static bool texturedSprites = false;   // toggled with 'T'
+const double ASSET_UPLOAD_BUDGET_MS = 2.0;
+
+// shader sources baked into the pack (PACK_RAW entries named by their path);
+// a loose file edited after the pack was built wins, nothing rebuilds the pack
+static long long assetPackTime = 0;
+static bool packedShaderSource(const std::string& path, std::string& source) {
+    if (ShaderWatcher::mtime(path) > assetPackTime) return false;
+    const PackEntry* e = assetPack.find(path.c_str());
+    if (!e || e->type != PACK_RAW) return false;
+    source.assign((const char*)assetPack.data(*e), (size_t)e->size);
+    return true;
+}
+
+// locations change when the program is relinked, so this runs after reloads too
+static void lookupRectUniforms() {
+    uViewOffsetLoc  = glGetUniformLocation(rectShader->ID, "viewOffset");
+    uUseGradientLoc = glGetUniformLocation(rectShader->ID, "useGradient");
+    uGradTopLoc     = glGetUniformLocation(rectShader->ID, "gradTop");
+    uGradBottomLoc  = glGetUniformLocation(rectShader->ID, "gradBottom");
+    uTimeLoc        = glGetUniformLocation(rectShader->ID, "time");
+    uDepthLoc       = glGetUniformLocation(rectShader->ID, "depth");
+}
+
+// Every hot-reloadable program, plus what to refresh after it relinks
+struct ReloadTarget {
+    Shader* shader;
+    std::function<void()> onReload;
+};
+static std::vector<ReloadTarget> reloadTargets;
+
+static void watchShader(Shader* shader, std::function<void()> onReload = nullptr) {
+    reloadTargets.push_back(ReloadTarget{ shader, onReload });
+    shaderWatcher.track(shader->vertexPath);
+    shaderWatcher.track(shader->fragmentPath);
+}
+
+// recompile programs whose sources changed on disk; a failed compile keeps
+// the previous program running
+static void reloadChangedShaders() {
+    for (const std::string& path : shaderWatcher.poll(timeNow)) {
+        for (ReloadTarget& t : reloadTargets) {
+            if (path != t.shader->vertexPath && path != t.shader->fragmentPath) continue;
+            if (t.shader->reload()) {
+                if (t.onReload) t.onReload();
+                std::cout << "reloaded " << path << "\n";
+            }
+        }
+    }
+}
+
+// Frame graph stats: GPU time, render-target memory and frame arena use
+// go in the title every frame, the per-pass breakdown and the arena's
+// worst frame are printed every couple of seconds
+struct ArenaUsage {
+    size_t   peak = 0, fallbackBytes = 0;
+    uint64_t frames = 0, fallbackFrames = 0, fallbacks = 0, heapAllocs = 0;
+};
+static ArenaUsage arenaUsage;
+
+static void reportFrameGraph(GLFWwindow* window, std::pmr::string& title, const FrameArena& arena,
+                             uint64_t frameAllocs) {
+    char stats[192];
+    snprintf(stats, sizeof(stats), "   |  GPU %.2f ms  RT %.1f MB (%.1f MB unaliased)  passes %d (+%d culled)"
+             "  arena %.1f KB%s",
+             frameGraph.timer.total(), frameGraph.pooledBytes / 1048576.0,
+             frameGraph.virtualBytes / 1048576.0, frameGraph.passesRun, frameGraph.passesCulled,
+             arena.peak() / 1024.0, arena.fallbacks() ? " (heap fallback)" : "");
+    title += stats;
+    glfwSetWindowTitle(window, title.c_str());
+
+    ArenaUsage& u = arenaUsage;
+    u.peak = std::max(u.peak, arena.peak());
+    u.frames++;
+    u.fallbackFrames += arena.fallbacks() ? 1 : 0;
+    u.fallbacks += arena.fallbacks();
+    u.fallbackBytes += arena.fallbackBytes();
+    u.heapAllocs += frameAllocs;
+
+    static float lastReport = 0.0f;
+    if (timeNow - lastReport < 2.0f) return;
+    lastReport = timeNow;
+    std::cout << "frame graph (bloom " << BLOOM_QUALITY_NAMES[bloom.quality] << "):";
+    for (int i = 0; i < frameGraph.timer.active(); ++i)
+        std::cout << "  " << frameGraph.timer.passes[i].name << " " << frameGraph.timer.passes[i].ms << " ms";
+    std::cout << "\n  layers drawn " << layers.layersDrawn << ", blend state changes " << layers.blendChanges << "\n";
+    printf("frame arena: peak %.1f KB of %.0f KB  heap fallbacks in %llu of %llu frames (%llu, %.1f KB)"
+           "  heap allocations %.2f/frame\n",
+           u.peak / 1024.0, arena.capacity() / 1024.0, (unsigned long long)u.fallbackFrames,
+           (unsigned long long)u.frames, (unsigned long long)u.fallbacks, u.fallbackBytes / 1024.0,
+           (double)u.heapAllocs / (double)u.frames);
+    u = ArenaUsage();
+}
 
 static inline void setSolidMode() {
     glUniform1i(uUseGradientLoc, 0);
-    glUniform1f(uGlowLoc, 1.0f);
 }
 static inline void setGradientMode(const glm::vec3& top, const glm::vec3& bottom) {
     glUniform1i(uUseGradientLoc, 1);
@@ -205,13 +282,410 @@ static inline void setGradientMode(const glm::vec3& top, const glm::vec3& bottom
     glUniform3f(uGradBottomLoc, bottom.r, bottom.g, bottom.b);
 }
 
-int main()
+// rect layers all share the program, atlas and view uniforms
+static void beginRectLayer(float depth) {
+    rectShader->use();
+    spriteAtlas.bind(0);
+    setSolidMode();
+    glUniform2f(uViewOffsetLoc, viewX, viewY);
+    glUniform1f(uTimeLoc, timeNow);
+    glUniform1f(uDepthLoc, depth);
+}
+
+static void declareLayers() {
+    // gradient fullscreen background (unshaken)
+    layerBackground = layers.declare("background", LAYER_OPAQUE, [](float depth) {
+        beginRectLayer(depth);
+        glUniform2f(uViewOffsetLoc, 0.0f, 0.0f);
+        setGradientMode(COLOR_BG_TOP, COLOR_BG_BOTTOM);
+        layers.batch(layerBackground).push(0.0f, 0.0f, 2.0f, 2.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+        layers.batch(layerBackground).flush();
+        setSolidMode();
+    });
+    // parallax stars: one instanced draw, positions computed in the shader
+    layerStars = layers.declare("stars", LAYER_ADDITIVE, [](float depth) {
+        starfield.draw(viewX, viewY, depth);
+    });
+    // motion trails behind everything that moves
+    layerTrails = layers.declare("trails", LAYER_ADDITIVE, [](float depth) {
+        trails.composite(frameGraph, trailBuffer, depth);
+    });
+    layerWorld     = layers.declare("world", LAYER_OPAQUE);           // divider, bullet
+    layerShapes    = layers.declare("shapes", LAYER_PREMULTIPLIED);   // SDF entities, sprites
+    layerParticles = layers.declare("particles", LAYER_ADDITIVE);
+    layers.beginRects = beginRectLayer;
+}
+
+// Buttons for the player of session slot `slot`: an attached agent's
+// (it sees `view` first), the bot's with --autopilot (always when
+// headless, window == nullptr), else the keys'
+static PlayerInput localInput(GLFWwindow* window, KeySet keys, int slot, const GameState& view) {
+    if (slot == 0 && agent.isOpen()) {
+        agent.publish(view, netMode == NET_OFF ? 0 : sessions[slot].localPlayer());
+        return agent.action();
+    }
+    if (autopilot || !window) return bots[slot].think(view);
+    return readInput(keys);
+}
+
+// One fixed tick in whichever mode is running. False when the presented
+// session is too far ahead of its peer and has to wait.
+static bool stepSimulation(GLFWwindow* window, uint32_t& events) {
+    if (netMode == NET_OFF) {
+        // holding BACKSPACE walks back one tick per tick while history lasts
+        if (window && keyState.down(GLFW_KEY_BACKSPACE)) {
+            if (game.tick > 0) history.restore(game.tick - 1, game);
+            return true;
+        }
+        PlayerInput in[MAX_PLAYERS] = { localInput(window, KEYS_ALL, 0, game), 0 };
+        history.save(game.tick, game);
+        simStep(game, in);
+        events |= game.events;
+        return true;
+    }
+    if (netMode == NET_LOOPBACK) {
+        // second local player; it stalls on its own, like a remote peer would
+        if (sessions[1].canAdvance()) sessions[1].advance(localInput(window, KEYS_RIGHT_HAND, 1, sessions[1].presented()));
+        else sessions[1].poll();
+    }
+    if (!sessions[0].canAdvance()) {
+        sessions[0].poll();
+        return false;
+    }
+    sessions[0].advance(localInput(window, netMode == NET_LOOPBACK ? KEYS_LEFT_HAND : KEYS_ALL, 0, sessions[0].presented()));
+    events |= sessions[0].presented().events;
+    return true;
+}
+
+static void printAgentStats() {
+    printf("agent: %llu observations, %llu answered, %llu timeouts  round trip p50 %.1f us  p99 %.1f us  max %.1f us\n",
+           (unsigned long long)agent.published, (unsigned long long)agent.answered,
+           (unsigned long long)agent.timeouts, agent.roundTrip.percentile(50) * 1e-3,
+           agent.roundTrip.percentile(99) * 1e-3, agent.roundTrip.max() * 1e-3);
+}
+
+// rollback and agent latency, printed every couple of seconds
+static void reportNetStats(double now) {
+    static double lastReport = 0.0;
+    if (now - lastReport < 2.0) return;
+    lastReport = now;
+    if (agent.isOpen()) {
+        printAgentStats();
+        agent.roundTrip.reset();
+    }
+    if (netMode == NET_OFF) return;
+    const RollbackStats& st = sessions[0].stats;
+    std::cout << "rollback: tick " << sessions[0].tick() << " (confirmed " << sessions[0].confirmedTick()
+              << ")  rollbacks " << st.rollbacks << "  max depth " << st.maxDepth
+              << "  resim " << st.ticksPerMs() << " ticks/ms  snapshot " << st.snapshotNs() << " ns"
+              << "  stalls " << st.stalls << "\n";
+}
+
+// =====================[ Simulation thread ]=====================
+// Fixed SIM_DT ticks on the thread's own clock: each tick ends at a fixed
+// time and takes the key events stamped before it, then the thread sleeps
+// until the next one is due. A slow frame no longer delays ticks and a
+// burst of catch-up ticks no longer delays a frame. `window` only says a
+// keyboard is there; all GLFW calls stay on the render thread.
+static void publishSnapshot(uint64_t ticks) {
+    RenderSnapshot& s = renderSnapshots.back();
+    s.state = presentedState();
+    s.ticks = ticks;
+    renderSnapshots.publish();
+}
+
+static void simThreadMain(GLFWwindow* window) {
+    using namespace std::chrono;
+    uint64_t ticks = 0;
+    double tickEnd = glfwGetTime() + SIM_DT;
+    while (simRunning.load(std::memory_order_acquire)) {
+        auto busyStart = steady_clock::now();
+        double now = glfwGetTime();
+        loopback.setTime(now * 1000.0);
+        tickEnd = std::max(tickEnd, now - 0.25);    // drop time lost to a long hitch
+        uint32_t events = 0;
+        uint64_t first = ticks;
+        bool stalled = false;
+        while (tickEnd <= now) {
+            keyState.consume(inputEvents, tickEnd);
+            uint32_t tickEvents = 0;
+            if (!stepSimulation(window, tickEvents)) { stalled = true; break; }
+            keyState.endTick();
+            audio.playEvents(tickEvents);
+            events |= tickEvents;
+            ticks++;
+            double pressed[KeyState::MAX_PENDING];
+            int n = keyState.takePending(pressed);
+            for (int i = 0; measureLatency && i < n; ++i) simPresses.push({ pressed[i], ticks });
+            tickEnd += SIM_DT;
+        }
+        if (ticks != first) {
+            publishSnapshot(ticks);
+            simEvents.fetch_or(events, std::memory_order_relaxed);
+        }
+        reportNetStats(now);
+        simTicksRun.store(ticks, std::memory_order_relaxed);
+        simBusyNs.fetch_add((uint64_t)duration_cast<nanoseconds>(steady_clock::now() - busyStart).count(),
+                            std::memory_order_relaxed);
+
+        // a stalled session polls its peer again in a millisecond
+        double wait = stalled ? 0.001 : tickEnd - glfwGetTime();
+        if (wait > 0.0) std::this_thread::sleep_for(duration<double>(wait));
+    }
+}
+
+// Share of wall time each thread spent working, every couple of seconds.
+// The render thread's wait in swap (and glFinish) counts as idle.
+struct ThreadUsage {
+    double   since = 0.0, renderBusy = 0.0, renderWait = 0.0;
+    uint64_t frames = 0, ticks = 0;
+};
+static ThreadUsage threadUsage;
+
+static void reportThreadUsage(double now) {
+    ThreadUsage& u = threadUsage;
+    double span = now - u.since;
+    if (span < 2.0) return;
+    double simBusy = simBusyNs.exchange(0, std::memory_order_relaxed) * 1e-9;
+    uint64_t ticks = simTicksRun.load(std::memory_order_relaxed);
+    printf("threads: sim %.1f%% busy (%.0f ticks/s)  render %.1f%% busy, %.1f%% waiting on swap (%.0f fps)\n",
+           100.0 * simBusy / span, (ticks - u.ticks) / span, 100.0 * u.renderBusy / span,
+           100.0 * u.renderWait / span, u.frames / span);
+    u = ThreadUsage();
+    u.since = now;
+    u.ticks = ticks;
+}
+
+static void printAudioReport(const AudioReport& r) {
+    printf("audio: mix p50 %.1f us  p99 %.1f us  max %.1f us per %.1f ms buffer  peak voices %u"
+           "  underruns %llu  dropped commands %llu\n",
+           r.mixP50Ns * 1e-3, r.mixP99Ns * 1e-3, r.mixMaxNs * 1e-3, 1000.0 * AUDIO_BLOCK / AUDIO_RATE,
+           r.peakVoices, (unsigned long long)r.underruns, (unsigned long long)r.dropped);
+}
+
+// Presses first shown by this frame's snapshot reach the screen when the GPU
+// finishes the frame: a fence after the swap marks that, checked once per
+// frame (waited on only if four frames are in flight). Only the
+// in-process part is seen, from the callback that received the event.
+struct LatencyFrame {
+    GLsync fence;
+    int    n;
+    double pressed[KeyState::MAX_PENDING];
+};
+static const int LATENCY_FRAMES = 4;
+static LatencyFrame latencyFrames[LATENCY_FRAMES];
+static int latencyHead = 0, latencyCount = 0;
+
+static void retireLatencyFrame() {
+    LatencyFrame& f = latencyFrames[latencyHead];
+    double now = glfwGetTime();
+    for (int i = 0; i < f.n; ++i) inputLatency.add((uint64_t)((now - f.pressed[i]) * 1e9));
+    glDeleteSync(f.fence);
+    latencyHead = (latencyHead + 1) % LATENCY_FRAMES;
+    latencyCount--;
+}
+
+static void recordInputLatency(uint64_t shownTicks) {
+    if (!measureLatency) return;
+    double pressed[KeyState::MAX_PENDING];
+    int n = 0;
+    while (n < KeyState::MAX_PENDING) {
+        const PressStamp* p = simPresses.peek();
+        if (!p || p->ticks > shownTicks) break;
+        pressed[n++] = p->time;
+        PressStamp done;
+        simPresses.pop(done);
+    }
+    if (n > 0) {
+        if (latencyCount == LATENCY_FRAMES) {
+            glClientWaitSync(latencyFrames[latencyHead].fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            retireLatencyFrame();
+        }
+        LatencyFrame& f = latencyFrames[(latencyHead + latencyCount++) % LATENCY_FRAMES];
+        f.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        f.n = n;
+        memcpy(f.pressed, pressed, sizeof(double) * n);
+    }
+    while (latencyCount > 0) {
+        GLenum r = glClientWaitSync(latencyFrames[latencyHead].fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (r != GL_ALREADY_SIGNALED && r != GL_CONDITION_SATISFIED) break;
+        retireLatencyFrame();
+    }
+
+    static float lastReport = 0.0f;
+    if (timeNow - lastReport < 2.0f || !inputLatency.frames()) return;
+    lastReport = timeNow;
+    printf("input -> present: %llu presses  p50 %.2f ms  p99 %.2f ms  max %.2f ms%s\n",
+           (unsigned long long)inputLatency.frames(), inputLatency.percentile(50) * 1e-6,
+           inputLatency.percentile(99) * 1e-6, inputLatency.max() * 1e-6, lateLatch ? "  (late latch)" : "");
+    inputLatency.reset();
+}
+
+// =====================[ Headless soak ]=====================
+// --headless: autopilot only, no window, ticks back to back. Frame time
+// percentiles, allocations and RSS are printed for every tenth of the run
+// so leaks and slowdowns show up as a trend. Only ticks that advanced
+// count; a versus session that stops advancing fails the soak.
+static void printSoakLine(const char* label, uint64_t tick, const FrameHistogram& h,
+                          uint64_t allocs, size_t rss, size_t rss0) {
+    printf("%-6s tick %10llu  p50 %7.2f us  p99 %7.2f us  p99.9 %8.2f us  max %8.2f us"
+           "  allocs %+lld (live %lld)  rss %.1f MB (%+.1f)\n",
+           label, (unsigned long long)tick, h.percentile(50) * 1e-3, h.percentile(99) * 1e-3,
+           h.percentile(99.9) * 1e-3, h.max() * 1e-3, (long long)allocs,
+           (long long)(soakAllocs.load() - soakFrees.load()),
+           rss / 1048576.0, ((double)rss - (double)rss0) / 1048576.0);
+}
+
+static int runHeadless(uint64_t ticks, bool withAudio) {
+    using namespace std::chrono;
+    FrameHistogram window, total;
+    const uint64_t every = std::max<uint64_t>(ticks / 10, 1);
+    size_t rss0 = residentBytes();
+    uint64_t allocs0 = soakAllocs.load(), windowAllocs = allocs0;
+    printf("headless soak: %llu ticks, %s\n", (unsigned long long)ticks,
+           netMode == NET_OFF ? "single player" : "versus");
+    const uint64_t STALL_LIMIT = 600;       // 10 s of network time without a tick
+    uint64_t polls = 0, stalled = 0, stalledRun = 0;
+    auto start = steady_clock::now();
+    for (uint64_t t = 1; t <= ticks;) {
+        auto t0 = steady_clock::now();
+        loopback.setTime((double)++polls * SIM_DT * 1000.0);
+        uint32_t events = 0;
+        if (!stepSimulation(nullptr, events)) {
+            stalled++;
+            if (++stalledRun == STALL_LIMIT) {
+                printf("soak: STALLED at tick %llu, no progress in %llu polls\n",
+                       (unsigned long long)(t - 1), (unsigned long long)STALL_LIMIT);
+                return 1;
+            }
+            continue;
+        }
+        stalledRun = 0;
+        uint64_t ns = (uint64_t)duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+        window.add(ns);
+        total.add(ns);
+        if (withAudio) {
+            // offline: one tick's worth of audio, outside the timed part
+            audio.playEvents(events);
+            audio.renderFor(SIM_DT);
+        }
+        if (t % every == 0) {
+            uint64_t a = soakAllocs.load();
+            printSoakLine("soak:", t, window, a - windowAllocs, residentBytes(), rss0);
+            windowAllocs = a;
+            window.reset();
+        }
+        ++t;
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    printSoakLine("total:", ticks, total, soakAllocs.load() - allocs0, residentBytes(), rss0);
+    const GameState& view = presentedState();
+    printf("        %.0f ticks/s  bot: %llu shots, %llu retargets, %llu restarts  score %d",
+           ticks / seconds, (unsigned long long)bots[0].shots, (unsigned long long)bots[0].retargets,
+           (unsigned long long)bots[0].restarts, view.players[netMode == NET_OFF ? 0 : sessions[0].localPlayer()].score);
+    if (netMode != NET_OFF)
+        printf("  rollbacks %llu  stalled polls %llu (%.1f%%)", (unsigned long long)sessions[0].stats.rollbacks,
+               (unsigned long long)stalled, 100.0 * (double)stalled / (double)polls);
+    printf("\n");
+    if (agent.isOpen()) printAgentStats();
+    AudioReport report;
+    audio.flushReport();
+    if (withAudio && audio.takeReport(report)) printAudioReport(report);
+    return 0;
+}
+
+int main(int argc, char** argv)
 {
+    // --versus [--latency MS] [--jitter MS] [--loss PCT]: both players here,
+    //     over the in-process loopback (P1: A/D + SPACE, P2: arrows + ENTER)
+    // --versus-udp LOCALPORT HOST REMOTEPORT PLAYER: one player per machine
+    // --rollback N: prediction window in ticks
+    // --autopilot: bots play; --headless [--ticks N]: bots only, no window
+    // --late-latch: poll keys and take the newest snapshot right before drawing
+    // --measure-latency: print key press -> present latency every 2 s
+    // --agent NAME [--lockstep]: player 1 is driven through shared memory
+    //     /NAME by an external process (tools/agent_example.cpp)
+    uint32_t seed = (uint32_t)time(NULL);
+    int maxRollback = ROLLBACK_MAX_TICKS;
+    int udpPlayer = 0, udpLocalPort = 0, udpRemotePort = 0;
+    std::string udpHost;
+    bool headless = false;
+    uint64_t headlessTicks = 1000000;
+    std::string agentName;
+    std::string audioPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stars" && i + 1 < argc)
+            starCount = std::max(0, atoi(argv[++i]));
+        else if (arg == "--versus")
+            netMode = NET_LOOPBACK;
+        else if (arg == "--latency" && i + 1 < argc)
+            loopback.latencyMs = atof(argv[++i]);
+        else if (arg == "--jitter" && i + 1 < argc)
+            loopback.jitterMs = atof(argv[++i]);
+        else if (arg == "--loss" && i + 1 < argc)
+            loopback.lossPercent = atof(argv[++i]);
+        else if (arg == "--rollback" && i + 1 < argc)
+            maxRollback = std::max(1, std::min(atoi(argv[++i]), ROLLBACK_RING - 1));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (arg == "--autopilot")
+            autopilot = true;
+        else if (arg == "--headless")
+            headless = autopilot = true;
+        else if (arg == "--agent" && i + 1 < argc)
+            agentName = argv[++i];
+        else if (arg == "--audio-wav" && i + 1 < argc)
+            audioPath = argv[++i];
+        else if (arg == "--lockstep")
+            agent.lockstep = true;
+        else if (arg == "--late-latch")
+            lateLatch = true;
+        else if (arg == "--measure-latency")
+            measureLatency = true;
+        else if (arg == "--ticks" && i + 1 < argc)
+            headlessTicks = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--versus-udp" && i + 4 < argc) {
+            netMode = NET_UDP;
+            udpLocalPort = atoi(argv[++i]);
+            udpHost = argv[++i];
+            udpRemotePort = atoi(argv[++i]);
+            udpPlayer = atoi(argv[++i]) ? 1 : 0;
+            seed = 0x6b057e5u;      // both peers must start from the same state
+        }
+    }
     srand((unsigned)time(NULL));
+
+    if (netMode == NET_UDP) {
+        if (!udp.open((uint16_t)udpLocalPort, udpHost.c_str(), (uint16_t)udpRemotePort)) {
+            std::cout << "Failed to open UDP transport\n";
+            return -1;
+        }
+        sessions[0].start(udpPlayer, &udp, seed);
+    } else if (netMode == NET_LOOPBACK) {
+        sessions[0].start(0, loopback.endpoint(0), seed);
+        sessions[1].start(1, loopback.endpoint(1), seed);
+    } else {
+        gameReset(game, 1, seed);
+    }
+    sessions[0].maxRollback = sessions[1].maxRollback = maxRollback;
+    bots[0].player = netMode == NET_UDP ? udpPlayer : 0;
+    if (!agentName.empty() && !agent.create(agentName.c_str())) {
+        std::cout << "Failed to create agent channel " << agentName << "\n";
+        return -1;
+    }
+    if (!audioPath.empty() && !audioWav.open(audioPath.c_str())) {
+        std::cout << "Failed to open " << audioPath << "\n";
+        return -1;
+    }
+    audio.init(audioPath.empty() ? static_cast<AudioBackend*>(&audioNull) : &audioWav);
+    if (headless) return runHeadless(headlessTicks, !audioPath.empty());
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_DEPTH_BITS, 24);   // opaque layers are depth sorted
 
     GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, windowBase, NULL, NULL);
     if (window == NULL)
@@ -222,6 +696,7 @@ int main()
     }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetKeyCallback(window, key_callback);
     glfwSwapInterval(1); // vsync for smoother motion
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -231,323 +706,323 @@ int main()
     }
 
     // ----[ SHADER COMPILATION / PROGRAM LINKING ]----
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    int success; char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+    // sources come from the pack when it has them; hot reloads read the files
+    if (assetPack.open("build/assets.pak")) {
+        assetPackTime = ShaderWatcher::mtime("build/assets.pak");
+        Shader::packedSources() = packedShaderSource;
     }
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    // ----[ VERTEX ARRAY / VERTEX BUFFER ]----
-    // Single unit quad centered at origin (size 1x1), we scale/translate in world
-    float vertices[] = {
-         0.5f,  0.5f, 0.0f,
-         0.5f, -0.5f, 0.0f,
-        -0.5f, -0.5f, 0.0f,
-         0.5f,  0.5f, 0.0f,
-        -0.5f, -0.5f, 0.0f,
-        -0.5f,  0.5f, 0.0f
-    };
-    unsigned int VBO, VAO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glUseProgram(shaderProgram);
-    uTransformLoc   = glGetUniformLocation(shaderProgram, "transform");
-    uColorLoc       = glGetUniformLocation(shaderProgram, "ourColor");
-    uUseGradientLoc = glGetUniformLocation(shaderProgram, "useGradient");
-    uGradTopLoc     = glGetUniformLocation(shaderProgram, "gradTop");
-    uGradBottomLoc  = glGetUniformLocation(shaderProgram, "gradBottom");
-    uGlowLoc        = glGetUniformLocation(shaderProgram, "glow");
+    rectShader = new Shader("resources/shaders/rect.vs", "resources/shaders/rect.fs");
+    shaderWatcher.start(SHADER_DIR);
+    watchShader(rectShader, lookupRectUniforms);
+    starfield.initGL(starCount);
+    watchShader(starfield.shader, []{ starfield.lookupUniforms(); });
+    bloom.initGL();
+    watchShader(bloom.bright);
+    watchShader(bloom.blur);
+    watchShader(bloom.composite);
+    trails.initGL();
+    watchShader(trails.blit);
+
+    // ----[ VERTEX ARRAY / INSTANCE BUFFER ]----
+    // Single unit quad centered at origin (size 1x1), offset/scale per instance
+    declareLayers();
+    trailBatch.initGL();
+    trailBatch.reserve(MAX_PARTICLES + MAX_GHOSTS + 1);
+
+    // ----[ SPRITE ATLAS ]----
+    stbi_set_flip_vertically_on_load(true);
+    spriteAtlas.initGL(1024, 1024);
+    spriteAtlas.finalize();
+    layers.initGL(spriteAtlas.white);
+    trailBatch.flat = spriteAtlas.white;
+    // decoded off-thread; sprites show the flat placeholder until uploaded
+    assets.start(&spriteAtlas, 2);
+    if (assetPack.isOpen())
+        assets.usePack(&assetPack);
+    spriteGhost  = assets.request("resources/awesomeface.png");
+    spritePlayer = assets.request("resources/container.jpg");
+
+    rectShader->use();
+    lookupRectUniforms();
+    rectShader->setInt("atlas", 0);
 
     float lastFrame  = 0.0f;
+    bool wasGameOver = false;
 
-    resetGame();
+    // ---- Simulation thread: ticks on its own, publishes snapshots ----
+    audio.start();
+    publishSnapshot(0);
+    simRunning.store(true, std::memory_order_release);
+    std::thread simThread(simThreadMain, window);
+    threadUsage.since = glfwGetTime();
 
     // =====================[ Main Loop ]=====================
     while (!glfwWindowShouldClose(window))
     {
-        timeNow = (float)glfwGetTime();
+        double frameStart = glfwGetTime();
+        uint64_t frameAllocs0 = soakAllocs.load(std::memory_order_relaxed);
+        FrameArena& frameMemory = frameArenas.begin();
+        timeNow = (float)frameStart;
         float deltaTime = timeNow - lastFrame;
         lastFrame = timeNow;
-        shootTimer += deltaTime;
-
-        processInput(window, deltaTime);
 
-        // restart if 'R'
-        if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && gameOver) {
-            resetGame();
+        // key events go to the sim thread through key_callback
+        glfwPollEvents();
+        processInput(window);
+
+        // ---- Update: whatever the sim thread published last ----
+        // `view` is this snapshot until the late latch; the passes read
+        // `snapshot`, which the latch may move to a newer one
+        const RenderSnapshot* snapshot = &renderSnapshots.acquire();
+        const GameState& view = snapshot->state;
+        uint32_t events = simEvents.exchange(0, std::memory_order_relaxed);
+
+        if (events & EVENT_LIFE_LOST) {
+            // Trigger a stronger shake on life loss
+            shakeTimer = 0.25f;
+            shakeStrength = 0.025f;
+        } else if (events & EVENT_KILL) {
+            // light camera shake
+            shakeTimer = std::max(shakeTimer, 0.15f);
+            shakeStrength = std::max(shakeStrength, 0.015f);
         }
 
-        // ---- Update ----
-        if (!gameOver)
-        {
-            // Bullet update
-            if (bulletActive) {
-                bulletY += BULLET_SPEED * deltaTime;
-                if (bulletY > 1.1f) bulletActive = false;
-            }
-
-            // Ghosts update
-            int aliveCount = 0;
-            for (auto &g : ghosts) {
-                if (!g.alive) continue;
-                aliveCount++;
-
-                // horizontal movement + wall bounce and drop
-                g.x += g.vx * deltaTime;
-
-                // Add subtle wave/bob to give life
-                float bob = sin(timeNow * 2.0f + g.phase) * 0.12f;
-                g.x += bob * deltaTime;
-
-                if (g.x + GHOST_W * 0.5f > 1.0f) {
-                    g.x = 1.0f - GHOST_W * 0.5f;
-                    g.vx = -std::fabs(g.vx);
-                    g.y -= GHOST_DROP;
-                } else if (g.x - GHOST_W * 0.5f < -1.0f) {
-                    g.x = -1.0f + GHOST_W * 0.5f;
-                    g.vx =  std::fabs(g.vx);
-                    g.y -= GHOST_DROP;
-                }
-
-                // reached player line?
-                if (g.y - GHOST_H * 0.5f <= PLAYER_Y + PLAYER_H * 0.5f) {
-                    g.alive = false;
-                    if (--lives <= 0) {
-                        gameOver = true;
-                    }
-                    // Trigger a stronger shake on life loss
-                    shakeTimer = 0.25f;
-                    shakeStrength = 0.025f;
-                }
-
-                // bullet collision
-                if (bulletActive &&
-                    aabbHit(bulletX, bulletY, BULLET_W, BULLET_H,
-                            g.x, g.y, GHOST_W, GHOST_H))
-                {
-                    g.alive = false;
-                    bulletActive = false;
-                    score += 10;
-
-                    // small global speed-up as difficulty ramp
-                    for (auto &gg : ghosts) {
-                        gg.vx *= 1.035f;
-                    }
-
-                    // Explosion particles
-                    int puff = 24;
-                    for (int i=0;i<puff;++i) {
-                        float ang = frand(0.0f, 6.28318f);
-                        float spd = frand(0.25f, 1.0f);
-                        Particle p;
-                        p.pos = glm::vec2(g.x, g.y);
-                        p.vel = glm::vec2(cosf(ang), sinf(ang)) * spd;
-                        p.life = 1.0f;
-                        p.size = frand(0.012f, 0.028f);
-                        particles.push_back(p);
-                    }
-
-                    // light camera shake
-                    shakeTimer = std::max(shakeTimer, 0.15f);
-                    shakeStrength = std::max(shakeStrength, 0.015f);
-                }
-            }
-
-            // all ghosts cleared → next wave
-            if (!gameOver && aliveCount == 0) {
-                int nextCount = std::min(MAX_GHOSTS, 4 + (score / 20)); // gradually increase count
-                float speedScale = 1.0f + (score / 100.0f);
-                spawnWave(nextCount, speedScale);
-            }
-
-            // Update particles
-            for (auto &p : particles) {
-                p.life -= deltaTime * 1.4f;
-                p.pos += p.vel * deltaTime;
-                p.vel *= (1.0f - 0.9f * deltaTime); // gentle drag
-            }
-            particles.erase(std::remove_if(particles.begin(), particles.end(),
-                [](const Particle& p){ return p.life <= 0.0f; }), particles.end());
-
-            // Update stars (vertical drift, wrap)
-            for (auto &s : stars) {
-                s.pos.y -= s.speed * deltaTime;
-                if (s.pos.y < -1.05f) {
-                    s.pos.y = 1.05f;
-                    s.pos.x = frand(-1.0f, 1.0f);
-                    s.alpha = 0.5f + frand(0.0f, 0.5f);
-                    s.size  = 0.004f + frand(0.0f, 0.01f);
-                }
-            }
-        }
+        // stars move on the GPU; only their clock runs here
+        if (!view.gameOver) starfield.update(deltaTime);
+        if (wasGameOver && !view.gameOver) starfield.reset();   // restarted
+        wasGameOver = view.gameOver != 0;
 
         // ---- Dynamic window title ----
-        std::string title;
-        if (gameOver) {
-            title = std::string("Ghost Busters  |  SCORE: ") + std::to_string(score) +
-                    "   GAME OVER  (press R to restart)";
+        std::pmr::string title("Ghost Busters  |  ", &frameMemory);
+        title.reserve(256);
+        if (view.numPlayers == 1) {
+            title += "SCORE: ";
+            title += std::to_string(view.players[0].score);
+        } else {
+            int s1 = view.players[0].score, s2 = view.players[1].score;
+            title += "P1: ";
+            title += std::to_string(s1);
+            title += "  P2: ";
+            title += std::to_string(s2);
+            if (view.gameOver)
+                title += s1 == s2 ? "   DRAW" : s1 > s2 ? "   P1 WINS" : "   P2 WINS";
+        }
+        if (view.gameOver) {
+            title += "   GAME OVER  (press R to restart)";
         } else {
-            title = std::string("Ghost Busters  |  SCORE: ") + std::to_string(score) +
-                    "   LIVES: " + std::to_string(lives) +
-                    "   [A/D or \xE2\x86\x90\xE2\x86\x92 to move, SPACE to shoot]";
+            title += "   LIVES: ";
+            title += std::to_string(view.lives);
+            title += "   [A/D or \xE2\x86\x90\xE2\x86\x92 to move, SPACE to shoot]";
         }
-        glfwSetWindowTitle(window, title.c_str());
 
         // =====================[ Rendering ]=====================
-        glClearColor(0,0,0,1);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glUseProgram(shaderProgram);
-
-        // View (screen shake)
-        glm::mat4 view(1.0f);
+        assets.pump(ASSET_UPLOAD_BUDGET_MS);
+        reloadChangedShaders();
+        // View (screen shake) — just an offset applied in the vertex shader
+        viewX = viewY = 0.0f;
         if (shakeTimer > 0.0f) {
             float s = shakeStrength * (shakeTimer / 0.25f);
-            float ox = frand(-s, s);
-            float oy = frand(-s, s);
-            view = glm::translate(glm::mat4(1.0f), glm::vec3(ox, oy, 0.0f));
+            viewX = frand(-s, s);
+            viewY = frand(-s, s);
             shakeTimer -= deltaTime;
             if (shakeTimer < 0.0f) shakeTimer = 0.0f;
         }
 
-        // helper to draw rectangles
-        auto drawRect = [&](const glm::vec3& pos, const glm::vec2& size, const glm::vec4& color, float glowMul = 1.0f){
-            glm::mat4 t = view;
-            t = glm::translate(t, pos);
-            t = glm::scale(t, glm::vec3(size.x, size.y, 1.0f));
-            glUniformMatrix4fv(uTransformLoc, 1, GL_FALSE, glm::value_ptr(t));
-            glUniform4f(uColorLoc, color.r, color.g, color.b, color.a);
-            glUniform1f(uGlowLoc, glowMul);
-            glUniform1i(uUseGradientLoc, 0);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-        };
-
-        // helper to draw gradient fullscreen background
-        auto drawGradientBG = [&](){
-            glm::mat4 t = glm::scale(glm::mat4(1.0f), glm::vec3(2.0f, 2.0f, 1.0f));
-            glUniformMatrix4fv(uTransformLoc, 1, GL_FALSE, glm::value_ptr(t));
-            setGradientMode(COLOR_BG_TOP, COLOR_BG_BOTTOM);
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+        // trail layers: drawn into the accumulation buffer only
+        auto drawTrailLayers = [&]() {
+            const GameState& drawn = snapshot->state;
+            rectShader->use();
+            spriteAtlas.bind(0);
+            setSolidMode();
+            for (int p = 0; p < drawn.numPlayers; ++p) {
+                const PlayerState& pl = drawn.players[p];
+                if (pl.bulletActive)
+                    trailBatch.push(pl.bulletX, pl.bulletY, BULLET_W * 0.8f, BULLET_H,
+                                    COLOR_BULLET.r, COLOR_BULLET.g, COLOR_BULLET.b, 0.6f);
+            }
+            drawn.world.each<Position, ParticleLife>([&](const Position& p, const ParticleLife& l) {
+                float a = glm::clamp(l.life, 0.0f, 1.0f);
+                trailBatch.push(p.x, p.y, l.size, l.size, 1.0f, 0.6f, 0.15f, 0.35f * a);
+            });
+            drawn.world.each<GhostX, GhostY, GhostVX>([&](const GhostX& gx, const GhostY& gy, const GhostVX& vx) {
+                if (std::fabs(vx.v) > TRAIL_GHOST_SPEED)
+                    trailBatch.push(gx.v, gy.v, GHOST_W * 0.8f, GHOST_H * 0.8f,
+                                    COLOR_GHOST.r, COLOR_GHOST.g, COLOR_GHOST.b, 0.25f);
+            });
+            glUniform2f(uViewOffsetLoc, viewX, viewY);
+            glUniform1f(uDepthLoc, 0.0f);
+            trailBatch.flush();
         };
 
-        // Background gradient
-        drawGradientBG();
-
-        // Parallax stars (render as tiny rects, additive-ish via glow)
-        for (auto &s : stars) {
-            float twinkle = 0.85f + 0.15f * sinf(timeNow * (2.0f + s.speed*6.0f) + s.pos.x*10.0f);
-            float a = s.alpha * twinkle;
-            drawRect(glm::vec3(s.pos, 0.0f), glm::vec2(s.size, s.size),
-                     glm::vec4(1.0f, 1.0f, 1.0f, a), 1.2f);
+        // Late latch: key events that arrived while this frame was built go
+        // to the sim thread now rather than next frame, and the passes draw
+        // whatever it has published since the top of the frame. `view` is
+        // not used past this point (its slot may be rewritten).
+        if (lateLatch) {
+            glfwPollEvents();
+            snapshot = &renderSnapshots.acquire();
         }
 
-        // bottom divider line
-        drawRect(glm::vec3(0.0f, PLAYER_Y + PLAYER_H*0.5f + 0.02f, 0.0f),
-                 glm::vec2(0.01f, 2.0f), glm::vec4(COLOR_DIVIDER, 1.0f));
-
-        // player blaster (base + turret) with subtle glow pulse while bullet is active cooldown
-        float playerPulse = 1.0f + 0.25f * std::max(0.0f, (SHOOT_COOLDOWN - shootTimer)) / SHOOT_COOLDOWN;
-        drawRect(glm::vec3(playerX, PLAYER_Y, 0.0f),
-                 glm::vec2(PLAYER_W, PLAYER_H), glm::vec4(COLOR_PLAYER, 1.0f), playerPulse);
-        drawRect(glm::vec3(playerX, PLAYER_Y + PLAYER_H*0.35f, 0.0f),
-                 glm::vec2(PLAYER_W*0.35f, PLAYER_H*0.6f), glm::vec4(COLOR_PLAYER, 1.0f), playerPulse);
-
-        // bullet (with simple trail)
-        if (bulletActive) {
-            drawRect(glm::vec3(bulletX, bulletY, 0.0f),
-                     glm::vec2(BULLET_W, BULLET_H), glm::vec4(COLOR_BULLET, 1.0f), 1.2f);
-            // trail quads fading behind
-            drawRect(glm::vec3(bulletX, bulletY - BULLET_H*0.8f, 0.0f),
-                     glm::vec2(BULLET_W*0.9f, BULLET_H*0.6f), glm::vec4(COLOR_BULLET, 0.6f), 1.0f);
-            drawRect(glm::vec3(bulletX, bulletY - BULLET_H*1.5f, 0.0f),
-                     glm::vec2(BULLET_W*0.8f, BULLET_H*0.4f), glm::vec4(COLOR_BULLET, 0.35f), 0.9f);
-        }
+        // Frame graph: trails first; with bloom the scene goes to an HDR
+        // target (keeps glow > 1) that the bloom passes read, without it
+        // straight out
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        frameGraph.reset(&frameMemory);
+        trailBuffer = trails.addPass(frameGraph, deltaTime, drawTrailLayers);
+
+        // the scene pass: everything the game draws, queued into the
+        // declared layers and drawn with one state change per layer
+        auto drawScene = [&](FrameGraph&) {
+            const GameState& drawn = snapshot->state;
+            glClearColor(0,0,0,1);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            RectBatch& worldRects = layers.batch(layerWorld);
+            RectBatch& shapes = layers.batch(layerShapes);
+
+            // bottom divider line
+            worldRects.push(0.0f, PLAYER_Y + PLAYER_H*0.5f + 0.02f, 0.01f, 2.0f,
+                            COLOR_DIVIDER.r, COLOR_DIVIDER.g, COLOR_DIVIDER.b, 1.0f);
+
+            // player blasters (base + turret) with subtle glow pulse while the shot cools down
+            for (int p = 0; p < drawn.numPlayers; ++p) {
+                const PlayerState& pl = drawn.players[p];
+                const glm::vec3& col = p == 0 ? COLOR_PLAYER : COLOR_PLAYER2;
+                float playerPulse = 1.0f + 0.25f * std::max(0.0f, (SHOOT_COOLDOWN - pl.shootTimer)) / SHOOT_COOLDOWN;
+                if (texturedSprites) {
+                    shapes.pushSprite(assets.sprite(spritePlayer), pl.x, PLAYER_Y, PLAYER_W, PLAYER_H,
+                                      col.r, col.g, col.b, 1.0f, playerPulse);
+                    worldRects.push(pl.x, PLAYER_Y + PLAYER_H*0.35f, PLAYER_W*0.35f, PLAYER_H*0.6f,
+                                    col.r, col.g, col.b, 1.0f, playerPulse);
+                } else {
+                    // one SDF instance: box spans the base bottom to the turret top
+                    shapes.pushShape(SHAPE_PLAYER, pl.x, PLAYER_Y + PLAYER_H*0.075f, PLAYER_W, PLAYER_H*1.15f,
+                                     col.r, col.g, col.b, 1.0f, playerPulse);
+                }
 
-        // ghosts (body + eyes); add glow pulse
-        for (auto &g : ghosts) if (g.alive) {
-            float glow = 0.85f + 0.35f * sinf(timeNow * 3.0f + g.phase);
-            // body
-            drawRect(glm::vec3(g.x, g.y, 0.0f),
-                     glm::vec2(GHOST_W, GHOST_H), glm::vec4(COLOR_GHOST, 1.0f), glow);
-            // eyes
-            float eyeOffX = GHOST_W * 0.18f;
-            float eyeOffY = GHOST_H * 0.10f;
-            glm::vec2 eyeSize = glm::vec2(GHOST_W*0.14f, GHOST_H*0.14f);
-            drawRect(glm::vec3(g.x - eyeOffX, g.y + eyeOffY, 0.0f),
-                     eyeSize, glm::vec4(COLOR_EYES, 1.0f), 1.0f);
-            drawRect(glm::vec3(g.x + eyeOffX, g.y + eyeOffY, 0.0f),
-                     eyeSize, glm::vec4(COLOR_EYES, 1.0f), 1.0f);
-        }
+                // bullet (its trail comes from the accumulation buffer)
+                if (pl.bulletActive) {
+                    worldRects.push(pl.bulletX, pl.bulletY, BULLET_W, BULLET_H,
+                                    COLOR_BULLET.r, COLOR_BULLET.g, COLOR_BULLET.b, 1.0f, 1.2f);
+                }
+            }
 
-        // particles (explosions)
-        for (auto &p : particles) {
-            float a = glm::clamp(p.life, 0.0f, 1.0f);
-            glm::vec4 col = glm::vec4(1.0f, 0.85f, 0.25f, a);
-            drawRect(glm::vec3(p.pos, 0.0f), glm::vec2(p.size, p.size), col, 1.0f + 0.5f*a);
+            // ghosts: one SDF instance each (body, skirt, eyes, rim); add glow pulse
+            drawn.world.each<GhostX, GhostY, GhostPhase>([&](const GhostX& gx, const GhostY& gy, const GhostPhase& ph) {
+                float glow = 0.85f + 0.35f * sinf(timeNow * 3.0f + ph.v);
+                if (texturedSprites)
+                    shapes.pushSprite(assets.sprite(spriteGhost), gx.v, gy.v, GHOST_W, GHOST_H,
+                                      COLOR_GHOST.r, COLOR_GHOST.g, COLOR_GHOST.b, 1.0f, glow);
+                else
+                    shapes.pushShape(SHAPE_GHOST, gx.v, gy.v, GHOST_W, GHOST_H,
+                                     COLOR_GHOST.r, COLOR_GHOST.g, COLOR_GHOST.b, 1.0f, glow);
+            });
+
+            // particles (explosions): additive, so fading alpha just dims them
+            RectBatch& sparks = layers.batch(layerParticles);
+            drawn.world.each<Position, ParticleLife>([&](const Position& p, const ParticleLife& l) {
+                float a = glm::clamp(l.life, 0.0f, 1.0f);
+                sparks.push(p.x, p.y, l.size, l.size, 1.0f, 0.85f, 0.25f, a, 1.0f + 0.5f*a);
+            });
+
+            layers.draw();
+        };
+
+        if (bloom.enabled()) {
+            FGTextureDesc sceneDesc;
+            sceneDesc.depth = true;             // for the opaque layers
+            FGResource scene = frameGraph.createTexture("scene", sceneDesc);
+            frameGraph.addPass("scene", { trailBuffer }, scene, drawScene);
+            bloom.addPasses(frameGraph, scene, FG_BACKBUFFER);
+        } else {
+            frameGraph.addPass("scene", { trailBuffer }, FG_BACKBUFFER, drawScene);
         }
+        frameGraph.execute(fbWidth, fbHeight);
+        reportFrameGraph(window, title, frameMemory, soakAllocs.load(std::memory_order_relaxed) - frameAllocs0);
 
+        double swapStart = glfwGetTime();
         glfwSwapBuffers(window);
-        glfwPollEvents();
+        // late latch: wait until this frame is shown, so the next one's
+        // latched input is not queued behind it
+        if (lateLatch) glFinish();
+        double frameEnd = glfwGetTime();
+        recordInputLatency(snapshot->ticks);
+
+        threadUsage.renderWait += frameEnd - swapStart;
+        threadUsage.renderBusy += swapStart - frameStart;
+        threadUsage.frames++;
+        reportThreadUsage(frameEnd);
+        AudioReport audioReport;
+        if (audio.takeReport(audioReport)) printAudioReport(audioReport);
     }
 
+    simRunning.store(false, std::memory_order_release);
+    simThread.join();
+    audio.stop();
+    audioWav.close();
+
     // Resource cleanup
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+    assets.stop();
+    layers.destroyGL();
+    trailBatch.destroyGL();
+    spriteAtlas.destroyGL();
+    glDeleteProgram(rectShader->ID);
+    delete rectShader;
+    starfield.destroyGL();
+    bloom.destroyGL();
+    trails.destroyGL();
+    frameGraph.destroyGL();
     glfwTerminate();
     return 0;
 }
 
 // =====================[ Input ]=====================
-void processInput(GLFWwindow *window, float deltaTime)
+// Buttons for one player this tick. In local versus the keyboard is split:
+// left hand A/D + SPACE, right hand arrows + ENTER.
+PlayerInput readInput(KeySet keys)
 {
-    // move player
-    float move = playerSpeed * deltaTime;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
-        playerX -= move;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
-        playerX += move;
-    // keep on screen
-    if (playerX + PLAYER_W*0.5f > 1.0f)  playerX = 1.0f - PLAYER_W*0.5f;
-    if (playerX - PLAYER_W*0.5f < -1.0f) playerX = -1.0f + PLAYER_W*0.5f;
-
-    // shooting (single bullet on screen, basic cooldown)
-    if (!gameOver && glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-        if (!bulletActive && shootTimer >= SHOOT_COOLDOWN) {
-            bulletActive = true;
-            bulletX = playerX;
-            bulletY = PLAYER_Y + PLAYER_H*0.5f + BULLET_H*0.6f;
-            shootTimer = 0.0f;
-        }
+    auto down = [](int key) { return keyState.down(key); };
+    bool leftHand = keys != KEYS_RIGHT_HAND, rightHand = keys != KEYS_LEFT_HAND;
+    PlayerInput in = 0;
+    if ((leftHand && down(GLFW_KEY_A)) || (rightHand && down(GLFW_KEY_LEFT)))
+        in |= INPUT_LEFT;
+    if ((leftHand && down(GLFW_KEY_D)) || (rightHand && down(GLFW_KEY_RIGHT)))
+        in |= INPUT_RIGHT;
+    if ((leftHand && down(GLFW_KEY_SPACE)) || (keys == KEYS_RIGHT_HAND && down(GLFW_KEY_ENTER)))
+        in |= INPUT_FIRE;
+    if (down(GLFW_KEY_R))
+        in |= INPUT_RESTART;
+    return in;
+}
+
+// Every press/release, stamped; repeats carry no new state
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (action == GLFW_REPEAT || key < 0) return;
+    InputEvent e;
+    e.time = glfwGetTime();
+    e.key = (int16_t)key;
+    e.down = action == GLFW_PRESS;
+    inputEvents.push(e);        // full (256 unconsumed): dropped
+}
+
+// Presentation-only keys; gameplay input goes through readInput
+void processInput(GLFWwindow *window)
+{
+    // toggle textured sprites (edge-triggered)
+    static bool tWasDown = false;
+    bool tDown = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+    if (tDown && !tWasDown) texturedSprites = !texturedSprites;
+    tWasDown = tDown;
+
+    // cycle bloom quality: off / low / medium / high
+    static bool bWasDown = false;
+    bool bDown = glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS;
+    if (bDown && !bWasDown) {
+        bloom.cycleQuality();
+        std::cout << "bloom: " << BLOOM_QUALITY_NAMES[bloom.quality] << "\n";
     }
+    bWasDown = bDown;
 
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
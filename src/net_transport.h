@@ -0,0 +1,213 @@
+// --------------------------------------------------------------------------
+//           net_transport.h — unreliable datagram transports
+//    Rollback only needs "send a small packet, maybe it arrives": inputs
+//    are resent every tick until acknowledged, so there is no reliability
+//    layer here.
+//      UdpTransport       non-blocking UDP socket to one peer
+//      LoopbackNetwork    two in-process endpoints with configurable
+//                         latency, jitter and loss, driven by an explicit
+//                         clock so benchmarks can run faster than real time;
+//                         packets are fixed-size slots, so it never
+//                         allocates once its queues have grown
+// --------------------------------------------------------------------------
+#ifndef NET_TRANSPORT_H
+#define NET_TRANSPORT_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+class Transport {
+public:
+    virtual ~Transport() {}
+    virtual void send(const void* data, size_t size) = 0;
+    // Next pending datagram into buf; its size, or 0 if nothing is waiting
+    virtual size_t recv(void* buf, size_t capacity) = 0;
+};
+
+// ---------------------------------------------------------------- UDP ----
+class UdpTransport : public Transport {
+public:
+    ~UdpTransport() { close(); }
+
+    // Bind localPort and talk to host:remotePort only
+    bool open(uint16_t localPort, const char* host, uint16_t remotePort)
+    {
+#ifdef _WIN32
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+        wsaStarted = true;
+#endif
+        sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (sock == INVALID) { close(); return false; }
+        sockaddr_in local;
+        memset(&local, 0, sizeof(local));
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        local.sin_port = htons(localPort);
+        if (bind(sock, (sockaddr*)&local, sizeof(local)) != 0) {
+            fprintf(stderr, "udp: cannot bind port %u\n", localPort);
+            close();
+            return false;
+        }
+#ifdef _WIN32
+        u_long nonBlocking = 1;
+        ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+        fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+        addrinfo hints, *res = nullptr;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        if (getaddrinfo(host, nullptr, &hints, &res) != 0 || !res) {
+            fprintf(stderr, "udp: cannot resolve %s\n", host);
+            close();
+            return false;
+        }
+        memcpy(&peer, res->ai_addr, sizeof(peer));
+        peer.sin_port = htons(remotePort);
+        freeaddrinfo(res);
+        return true;
+    }
+
+    void close()
+    {
+        if (sock != INVALID) {
+#ifdef _WIN32
+            closesocket(sock);
+#else
+            ::close(sock);
+#endif
+        }
+        sock = INVALID;
+#ifdef _WIN32
+        if (wsaStarted) WSACleanup();
+        wsaStarted = false;
+#endif
+    }
+
+    void send(const void* data, size_t size) override
+    {
+        if (sock == INVALID) return;
+        sendto(sock, (const char*)data, (int)size, 0, (const sockaddr*)&peer, sizeof(peer));
+    }
+
+    size_t recv(void* buf, size_t capacity) override
+    {
+        if (sock == INVALID) return 0;
+        for (;;) {
+            sockaddr_in from;
+            socklen_t fromLen = sizeof(from);
+            int n = (int)recvfrom(sock, (char*)buf, (int)capacity, 0, (sockaddr*)&from, &fromLen);
+            if (n <= 0) return 0;
+            // ignore strays from anyone but the peer
+            if (from.sin_addr.s_addr == peer.sin_addr.s_addr && from.sin_port == peer.sin_port)
+                return (size_t)n;
+        }
+    }
+
+private:
+#ifdef _WIN32
+    typedef SOCKET Socket;
+    static const Socket INVALID = INVALID_SOCKET;
+    bool wsaStarted = false;
+#else
+    typedef int Socket;
+    static const Socket INVALID = -1;
+#endif
+    Socket sock = INVALID;
+    sockaddr_in peer;
+};
+
+// ----------------------------------------------------------- Loopback ----
+class LoopbackNetwork {
+public:
+    double latencyMs = 0.0;     // one way
+    double jitterMs = 0.0;      // +- uniform
+    double lossPercent = 0.0;
+
+    // packets counters, both directions
+    uint64_t sent = 0, dropped = 0, delivered = 0;
+
+    explicit LoopbackNetwork(uint32_t seed = 12345) : rng(seed ? seed : 1)
+    {
+        ends[0].net = this; ends[0].side = 0;
+        ends[1].net = this; ends[1].side = 1;
+    }
+
+    // The owner advances time; packets become visible once it passes
+    // their delivery time
+    void setTime(double ms) { nowMs = ms; }
+    double time() const { return nowMs; }
+
+    Transport* endpoint(int side) { return &ends[side]; }
+
+private:
+    static const size_t MAX_DATAGRAM = 256;    // longer sends are truncated
+
+    struct Packet {
+        double deliverAt;
+        size_t size;
+        unsigned char bytes[MAX_DATAGRAM];
+    };
+    struct End : Transport {
+        LoopbackNetwork* net = nullptr;
+        int side = 0;
+        void send(const void* data, size_t size) override { net->push(side ^ 1, data, size); }
+        size_t recv(void* buf, size_t capacity) override { return net->pop(side, buf, capacity); }
+    };
+
+    End ends[2];
+    std::vector<Packet> inbox[2];     // ordered by delivery time
+    double nowMs = 0.0;
+    uint32_t rng;
+
+    float rand01()
+    {
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        return (float)(rng >> 8) * (1.0f / 16777216.0f);
+    }
+
+    void push(int to, const void* data, size_t size)
+    {
+        sent++;
+        if (rand01() * 100.0f < lossPercent) { dropped++; return; }
+        Packet p;
+        p.deliverAt = nowMs + latencyMs + (rand01() * 2.0f - 1.0f) * jitterMs;
+        p.size = std::min(size, MAX_DATAGRAM);
+        memcpy(p.bytes, data, p.size);
+        // keep the queue ordered by delivery time (jitter may reorder)
+        std::vector<Packet>& q = inbox[to];
+        auto it = q.end();
+        while (it != q.begin() && (it - 1)->deliverAt > p.deliverAt) --it;
+        q.insert(it, p);
+    }
+
+    size_t pop(int side, void* buf, size_t capacity)
+    {
+        std::vector<Packet>& q = inbox[side];
+        if (q.empty() || q.front().deliverAt > nowMs) return 0;
+        size_t n = std::min(capacity, q.front().size);
+        memcpy(buf, q.front().bytes, n);
+        q.erase(q.begin());
+        delivered++;
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                 rect_batch.h — instanced 2D rect fast path
+//    Each rect is an offset/scale pair plus color/glow; the vertex shader
+//    applies translate, scale and view shake directly, so the CPU side per
+//    rect is four float stores, a packed unorm8 color and three cached
+//    words, and the whole batch is one draw.
+//    Per-instance UVs index the sprite atlas; flat rects use its white texel.
+//    A shape id switches the fragment shader to a signed distance shape
+//    (ghost, blaster), so a whole entity is a single antialiased instance.
+// --------------------------------------------------------------------------
+#ifndef RECT_BATCH_H
+#define RECT_BATCH_H
+
+#include "glad.h"
+#include "atlas.h"
+#include "glm/glm/vec2.hpp"
+#include "glm/glm/vec4.hpp"
+#include "glm/glm/packing.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RECT_BATCH_SSE2 1
+#endif
+
+// Shape ids understood by rect.fs
+enum RectShape {
+    SHAPE_RECT   = 0,   // plain/textured rect
+    SHAPE_GHOST  = 1,   // round head, wavy skirt, eyes, glowing rim
+    SHAPE_PLAYER = 2    // rounded base + turret; box is (W, 1.15 H)
+};
+
+// SDF shapes draw a quad this much larger than their box (SHAPE_PAD in rect.vs)
+const float RECT_SHAPE_PAD = 1.35f;
+
+// One instance = one rect, 32 bytes. Layout matches the instanced
+// attributes below; center and size stay float (they change every rect and
+// converting them to half costs more than it saves on upload), the rest is
+// packed and decoded by vertex fetch (half floats, normalized integers).
+struct RectInstance {
+    float    x, y;      // center (world units, NDC-like)
+    float    w, h;      // SDF shapes: the shape's box, the quad is padded
+    uint32_t color;     // unorm8 rgba
+    uint32_t glowShape; // half2 glow multiplier, RectShape
+    uint32_t uvMin;     // unorm16 atlas UV rect
+    uint32_t uvMax;
+};
+
+class RectBatch {
+public:
+    std::vector<RectInstance> rects;
+    Sprite flat{};      // UVs used by untextured rects (atlas white texel)
+
+    void reserve(size_t n) { rects.reserve(n); }
+    void clear() { rects.clear(); }
+    size_t size() const { return rects.size(); }
+
+    // CPU side of a rect: just stores and a color pack, no matrix work
+    inline void push(float x, float y, float w, float h,
+                     float r, float g, float b, float a, float glow = 1.0f)
+    {
+        rects.push_back(pack(x, y, w, h, r, g, b, a, glow, flat, SHAPE_RECT));
+    }
+
+    // Textured rect: same cost as a flat one, just different UVs
+    inline void pushSprite(const Sprite& sp, float x, float y, float w, float h,
+                           float r, float g, float b, float a, float glow = 1.0f)
+    {
+        rects.push_back(pack(x, y, w, h, r, g, b, a, glow, sp, SHAPE_RECT));
+    }
+
+    // Whole entity drawn from a distance function in the fragment shader
+    inline void pushShape(RectShape shape, float x, float y, float w, float h,
+                          float r, float g, float b, float a, float glow = 1.0f)
+    {
+        rects.push_back(pack(x, y, w, h, r, g, b, a, glow, flat, shape));
+    }
+
+    // ---- GL side ----
+    // Builds a VAO: location 0 = unit quad corner (per vertex),
+    // 1 = center, 2 = color, 3 = glow + shape, 4 = uv rect, 5 = size (per instance)
+    void initGL()
+    {
+        static const float quad[] = {
+             0.5f,  0.5f,
+             0.5f, -0.5f,
+            -0.5f, -0.5f,
+             0.5f,  0.5f,
+            -0.5f, -0.5f,
+            -0.5f,  0.5f
+        };
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &quadVBO);
+        glGenBuffers(1, &instanceVBO);
+        glBindVertexArray(vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        const GLsizei stride = sizeof(RectInstance);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(RectInstance, x));
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(RectInstance, color));
+        glVertexAttribPointer(3, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(RectInstance, glowShape));
+        glVertexAttribPointer(4, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(RectInstance, uvMin));
+        glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(RectInstance, w));
+        for (int i = 1; i <= 5; ++i) {
+            glEnableVertexAttribArray(i);
+            glVertexAttribDivisor(i, 1);
+        }
+        glBindVertexArray(0);
+    }
+
+    // Upload all queued rects and draw them with one instanced call, then clear
+    void flush()
+    {
+        if (rects.empty()) return;
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        size_t bytes = rects.size() * sizeof(RectInstance);
+        if (bytes > capacityBytes) capacityBytes = bytes * 2;
+        // (re)allocating every flush orphans the old storage, so the driver
+        // doesn't stall on last frame's data
+        glBufferData(GL_ARRAY_BUFFER, capacityBytes, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, rects.data());
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)rects.size());
+        rects.clear();
+    }
+
+    void destroyGL()
+    {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &quadVBO);
+        glDeleteBuffers(1, &instanceVBO);
+    }
+
+private:
+    unsigned int vao = 0, quadVBO = 0, instanceVBO = 0;
+    size_t capacityBytes = 0;
+
+    // the last packed UV rect and glow/shape; runs of one sprite (or flat)
+    // and one kind of entity skip the packing
+    Sprite lastUV{ -1.0f, -1.0f, -1.0f, -1.0f, 0, 0 };
+    uint32_t lastUVMin = 0, lastUVMax = 0;
+    float lastGlow = -1.0f;
+    RectShape lastShape = SHAPE_RECT;
+    uint32_t lastGlowShape = 0;
+
+    inline RectInstance pack(float x, float y, float w, float h,
+                             float r, float g, float b, float a, float glow,
+                             const Sprite& uv, RectShape shape)
+    {
+        if (uv.u0 != lastUV.u0 || uv.v0 != lastUV.v0 || uv.u1 != lastUV.u1 || uv.v1 != lastUV.v1) {
+            lastUV = uv;
+            lastUVMin = glm::packUnorm2x16(glm::vec2(uv.u0, uv.v0));
+            lastUVMax = glm::packUnorm2x16(glm::vec2(uv.u1, uv.v1));
+        }
+        if (glow != lastGlow || shape != lastShape) {
+            lastGlow = glow;
+            lastShape = shape;
+            lastGlowShape = glm::packHalf2x16(glm::vec2(glow, (float)shape));
+        }
+        RectInstance ri;
+        ri.x = x;
+        ri.y = y;
+        ri.w = w;
+        ri.h = h;
+        ri.color = packColor(r, g, b, a);
+        ri.glowShape = lastGlowShape;
+        ri.uvMin = lastUVMin;
+        ri.uvMax = lastUVMax;
+        return ri;
+    }
+
+    // rgba in [0, 1] (clamped) to unorm8, round to nearest
+    static inline uint32_t packColor(float r, float g, float b, float a)
+    {
+#ifdef RECT_BATCH_SSE2
+        __m128 v = _mm_min_ps(_mm_max_ps(_mm_set_ps(a, b, g, r), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        // + 0.5 and truncate: halves round up, as in glm::packUnorm4x8
+        __m128i i = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+        i = _mm_packs_epi32(i, i);
+        return (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(i, i));
+#else
+        return glm::packUnorm4x8(glm::vec4(r, g, b, a));
+#endif
+    }
+
+};
+
+#endif
@@ -0,0 +1,125 @@
+// --------------------------------------------------------------------------
+//         render_layers.h — declared draw layers with fixed blend modes
+//    Layers are declared once, back to front, each with a blend mode:
+//      opaque         blend off, depth write; drawn front-to-back so the
+//                     depth test rejects hidden pixels early
+//      premultiplied  ONE, ONE_MINUS_SRC_ALPHA
+//      additive       ONE, ONE
+//    Every shader outputs premultiplied color, so one state change per layer
+//    is all blending costs; nothing inside a layer is sorted. Each layer
+//    gets its own depth (uniform), which keeps blended layers behind nearer
+//    opaque ones.
+//    A layer either flushes its rect batch or runs a custom draw.
+// --------------------------------------------------------------------------
+#ifndef RENDER_LAYERS_H
+#define RENDER_LAYERS_H
+
+#include "glad.h"
+#include "rect_batch.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+enum LayerBlend { LAYER_OPAQUE = 0, LAYER_PREMULTIPLIED, LAYER_ADDITIVE };
+
+class RenderLayers {
+public:
+    typedef std::function<void(float depth)> DrawFn;
+
+    // runs before a rect layer is flushed (program, atlas, view uniforms)
+    DrawFn beginRects;
+
+    // per-frame stats, valid after draw()
+    int layersDrawn = 0, blendChanges = 0;
+
+    // Declare back to front, before initGL. Returns the layer id.
+    int declare(const char* name, LayerBlend blend, DrawFn custom = nullptr)
+    {
+        std::unique_ptr<Layer> l(new Layer());
+        l->name = name;
+        l->blend = blend;
+        l->custom = custom;
+        layers.push_back(std::move(l));
+        return (int)layers.size() - 1;
+    }
+
+    void initGL(const Sprite& flat)
+    {
+        for (auto& l : layers) {
+            l->batch.initGL();
+            l->batch.flat = flat;
+        }
+    }
+
+    RectBatch& batch(int id) { return layers[id]->batch; }
+    const char* name(int id) const { return layers[id]->name; }
+    size_t count() const { return layers.size(); }
+
+    // NDC depth for a layer: back layer farthest, all strictly inside (-1, 1)
+    float depth(int id) const { return 1.0f - 2.0f * (float)(id + 1) / (float)(layers.size() + 1); }
+
+    void draw()
+    {
+        layersDrawn = blendChanges = 0;
+        int current = -1;
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LEQUAL);
+
+        // opaque, nearest first
+        glDepthMask(GL_TRUE);
+        for (int i = (int)layers.size() - 1; i >= 0; --i)
+            if (layers[i]->blend == LAYER_OPAQUE) drawLayer(i, current);
+
+        // blended, back to front, tested against the opaque depth
+        glDepthMask(GL_FALSE);
+        for (int i = 0; i < (int)layers.size(); ++i)
+            if (layers[i]->blend != LAYER_OPAQUE) drawLayer(i, current);
+
+        glDepthMask(GL_TRUE);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+    }
+
+    void destroyGL()
+    {
+        for (auto& l : layers) l->batch.destroyGL();
+    }
+
+private:
+    struct Layer {
+        const char* name;
+        LayerBlend blend;
+        DrawFn custom;
+        RectBatch batch;
+    };
+    std::vector<std::unique_ptr<Layer>> layers;
+
+    void setBlend(LayerBlend b, int& current)
+    {
+        if ((int)b == current) return;
+        if (b == LAYER_OPAQUE) {
+            glDisable(GL_BLEND);
+        } else {
+            if (current <= LAYER_OPAQUE) glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, b == LAYER_ADDITIVE ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+        }
+        current = (int)b;
+        blendChanges++;
+    }
+
+    void drawLayer(int i, int& current)
+    {
+        Layer& l = *layers[i];
+        if (!l.custom && l.batch.size() == 0) return;
+        setBlend(l.blend, current);
+        if (l.custom) {
+            l.custom(depth(i));
+        } else {
+            if (beginRects) beginRects(depth(i));
+            l.batch.flush();
+        }
+        layersDrawn++;
+    }
+};
+
+#endif
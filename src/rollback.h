@@ -0,0 +1,222 @@
+// --------------------------------------------------------------------------
+//              rollback.h — rollback netcode for versus mode
+//    Each peer simulates every tick immediately, predicting the remote
+//    player's input as "same as the last one we know". The state before
+//    each tick is snapshotted into a ring. When a real remote input arrives
+//    that differs from the prediction for tick t, the session restores the
+//    snapshot of t and re-simulates up to the present with corrected
+//    inputs. A peer never runs more than maxRollback ticks past the last
+//    confirmed remote input; past that it stalls instead.
+//
+//    Packets carry every local input the peer has not acknowledged yet, so
+//    a lost packet is repaired by the next one. A peer also stalls rather
+//    than let its unacknowledged inputs outgrow one packet (the ring).
+//
+//    Tick distances are compared signed: either peer may be ahead.
+//
+//    Re-simulation throughput and snapshot cost are measured: together
+//    they bound how many ticks (how much latency) can be rolled back
+//    within a frame.
+// --------------------------------------------------------------------------
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include "game_state.h"
+#include "net_transport.h"
+#include "snapshot.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const int ROLLBACK_RING = 32;           // snapshots/inputs kept, power of two
+const int ROLLBACK_MAX_TICKS = 8;       // default prediction window
+
+struct InputPacket {
+    char     magic[4];      // "GBIN"
+    uint32_t startTick;     // tick of inputs[0]
+    uint32_t ackTick;       // sender has all of our inputs before this tick
+    uint8_t  count;
+    uint8_t  player;
+    uint8_t  reserved[2];
+    PlayerInput inputs[ROLLBACK_RING];
+};
+
+struct RollbackStats {
+    uint64_t ticks = 0;             // advanced, not counting re-simulation
+    uint64_t rollbacks = 0;
+    uint64_t resimTicks = 0;
+    double   resimMs = 0.0;
+    uint64_t snapshots = 0;
+    double   snapshotMs = 0.0;
+    int      maxDepth = 0;          // deepest rollback, in ticks
+    uint64_t stalls = 0;            // advance refused: too far ahead
+
+    double ticksPerMs() const { return resimMs > 0.0 ? resimTicks / resimMs : 0.0; }
+    double snapshotNs() const { return snapshots ? snapshotMs * 1e6 / snapshots : 0.0; }
+};
+
+class RollbackSession {
+public:
+    RollbackStats stats;
+    int maxRollback = ROLLBACK_MAX_TICKS;
+
+    void start(int localPlayer, Transport* transport, uint32_t seed)
+    {
+        local = localPlayer;
+        remote = localPlayer ^ 1;
+        net = transport;
+        current = 0;
+        remoteTick = 0;
+        peerAck = 0;
+        rollbackFrom = NO_ROLLBACK;
+        memset(inputs, 0, sizeof(inputs));
+        snapshots.clear();
+        gameReset(state, 2, seed);
+        stats = RollbackStats();
+    }
+
+    const GameState& presented() const { return state; }
+    uint32_t tick() const { return current; }
+    int localPlayer() const { return local; }
+    uint32_t confirmedTick() const { return remoteTick; }
+
+    // false while we would run more than maxRollback ticks ahead of the
+    // remote inputs we have, or the peer has not acknowledged a whole
+    // ring of ours. The window is capped so that the snapshot a rollback
+    // needs is always still in the ring.
+    bool canAdvance() const
+    {
+        int window = maxRollback < 1 ? 1 : maxRollback > ROLLBACK_RING - 1 ? ROLLBACK_RING - 1 : maxRollback;
+        return (int32_t)(current - remoteTick) < window && (int32_t)(current - peerAck) < ROLLBACK_RING;
+    }
+
+    // Simulate one tick with the local input (after any pending rollback)
+    void advance(PlayerInput localInput)
+    {
+        poll();
+        if (!canAdvance()) {
+            stats.stalls++;
+            return;
+        }
+        PlayerInput* in = inputs[current & (ROLLBACK_RING - 1)];
+        in[local] = localInput;
+        if (current >= remoteTick)          // predict: repeat the last known
+            in[remote] = remoteTick ? inputs[(remoteTick - 1) & (ROLLBACK_RING - 1)][remote] : 0;
+        saveSnapshot(current);
+        simStep(state, in);
+        current++;
+        stats.ticks++;
+        sendInputs();
+    }
+
+    // Receive remote inputs and roll back if a prediction was wrong. Safe
+    // to call every frame, also while stalled (it resends our inputs).
+    void poll()
+    {
+        InputPacket pkt;
+        size_t n;
+        // remote inputs may run ahead of us, but not into the slots of
+        // ticks a rollback could still re-simulate
+        const uint32_t oldestNeeded = (int32_t)(remoteTick - current) < 0 ? remoteTick : current;
+        while ((n = net->recv(&pkt, sizeof(pkt))) > 0) {
+            if (n < offsetof(InputPacket, inputs) || memcmp(pkt.magic, "GBIN", 4) != 0) continue;
+            if (pkt.player != remote || pkt.count > ROLLBACK_RING) continue;
+            if (pkt.ackTick > peerAck) peerAck = pkt.ackTick;
+            for (uint32_t k = 0; k < pkt.count; ++k) {
+                uint32_t t = pkt.startTick + k;
+                if (t != remoteTick) continue;  // only extend the contiguous range
+                if (t - oldestNeeded >= (uint32_t)ROLLBACK_RING) break;
+                PlayerInput& slot = inputs[t & (ROLLBACK_RING - 1)][remote];
+                if (t < current && slot != pkt.inputs[k] && t < rollbackFrom) rollbackFrom = t;
+                slot = pkt.inputs[k];
+                remoteTick++;
+            }
+        }
+        if (rollbackFrom != NO_ROLLBACK) rollback();
+        if (resendDue()) sendInputs();
+    }
+
+private:
+    static const uint32_t NO_ROLLBACK = 0xffffffffu;
+
+    int local = 0, remote = 1;
+    Transport* net = nullptr;
+    GameState state;
+    SnapshotRing<GameState, ROLLBACK_RING> snapshots;
+    PlayerInput inputs[ROLLBACK_RING][MAX_PLAYERS];
+    uint32_t current = 0;       // next tick to simulate
+    uint32_t remoteTick = 0;    // remote inputs known for all ticks before this
+    uint32_t peerAck = 0;       // peer has our inputs for all ticks before this
+    uint32_t rollbackFrom = NO_ROLLBACK;
+    uint32_t idlePolls = 0;     // polls since we last sent
+
+    static double msSince(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    void saveSnapshot(uint32_t t)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        snapshots.save(t, state);
+        stats.snapshotMs += msSince(t0);
+        stats.snapshots++;
+    }
+
+    void rollback()
+    {
+        uint32_t from = rollbackFrom;
+        rollbackFrom = NO_ROLLBACK;
+        int depth = (int)(current - from);
+        stats.rollbacks++;
+        if (depth > stats.maxDepth) stats.maxDepth = depth;
+
+        auto t0 = std::chrono::steady_clock::now();
+        if (!snapshots.restore(from, state)) {
+            // canAdvance() keeps the window inside the ring; resimulating
+            // from the wrong state would desync silently
+            fprintf(stderr, "rollback: snapshot of tick %u already evicted at tick %u\n", from, current);
+            abort();
+        }
+        for (uint32_t t = from; t < current; ++t) {
+            PlayerInput* in = inputs[t & (ROLLBACK_RING - 1)];
+            if (t >= remoteTick)            // still unconfirmed: re-predict
+                in[remote] = remoteTick ? inputs[(remoteTick - 1) & (ROLLBACK_RING - 1)][remote] : 0;
+            if (t != from) saveSnapshot(t);
+            simStep(state, in);
+        }
+        stats.resimMs += msSince(t0);
+        stats.resimTicks += (uint64_t)depth;
+    }
+
+    // while stalled (or once the game stops advancing) nothing sends, so
+    // keep the peer fed once per tick's worth of polls until it has all
+    // our inputs; our last packet may have been the one that was lost
+    bool resendDue()
+    {
+        if (peerAck == current) return false;
+        if (++idlePolls < 4) return false;
+        return true;
+    }
+
+    void sendInputs()
+    {
+        InputPacket pkt;
+        memcpy(pkt.magic, "GBIN", 4);
+        uint32_t first = peerAck;
+        if (current - first > ROLLBACK_RING) first = current - ROLLBACK_RING;
+        pkt.startTick = first;
+        pkt.ackTick = remoteTick;
+        pkt.count = (uint8_t)(current - first);
+        pkt.player = (uint8_t)local;
+        pkt.reserved[0] = pkt.reserved[1] = 0;
+        for (uint32_t t = first; t < current; ++t)
+            pkt.inputs[t - first] = inputs[t & (ROLLBACK_RING - 1)][local];
+        net->send(&pkt, offsetof(InputPacket, inputs) + pkt.count);
+        idlePolls = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,113 @@
+// --------------------------------------------------------------------------
+//              shader_watch.h — shader file change detection
+//    Linux: inotify on the shader directory, read non-blocking once per
+//    frame. Elsewhere: modification times are polled twice a second.
+//    Editors often save by rename, so moves into the directory count too.
+// --------------------------------------------------------------------------
+#ifndef SHADER_WATCH_H
+#define SHADER_WATCH_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <climits>
+#endif
+
+class ShaderWatcher {
+public:
+    ~ShaderWatcher() { stop(); }
+
+    // watch every file in dir (a path like "resources/shaders")
+    bool start(const std::string& directory)
+    {
+        dir = directory;
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) return false;
+        if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        return true;
+#else
+        return true;
+#endif
+    }
+
+    void stop()
+    {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+        fd = -1;
+#endif
+    }
+
+    // modification time in seconds, 0 if the file is missing
+    static long long mtime(const std::string& path)
+    {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return 0;
+        return (long long)st.st_mtime;
+    }
+
+    // the polling fallback (non-Linux) needs to know which files to stat
+    void track(const std::string& path)
+    {
+        Tracked t{ path, mtime(path) };
+        tracked.push_back(t);
+    }
+
+    // Paths (dir + "/" + name) changed since the last call; cheap when idle
+    std::vector<std::string> poll(double now)
+    {
+        std::vector<std::string> changed;
+#ifdef __linux__
+        (void)now;
+        if (fd < 0) return changed;
+        alignas(inotify_event) char buf[4096];
+        for (;;) {
+            ssize_t len = read(fd, buf, sizeof(buf));
+            if (len <= 0) break;
+            for (char* p = buf; p < buf + len; ) {
+                inotify_event* ev = (inotify_event*)p;
+                if (ev->len > 0) {
+                    std::string path = dir + "/" + ev->name;
+                    if (std::find(changed.begin(), changed.end(), path) == changed.end())
+                        changed.push_back(path);
+                }
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+#else
+        if (now - lastPoll < 0.5) return changed;
+        lastPoll = now;
+        for (auto& t : tracked) {
+            long long m = mtime(t.path);
+            if (m != t.mtime) {
+                t.mtime = m;
+                changed.push_back(t.path);
+            }
+        }
+#endif
+        return changed;
+    }
+
+private:
+    struct Tracked { std::string path; long long mtime; };
+    std::string dir;
+    std::vector<Tracked> tracked;
+    double lastPoll = 0.0;
+#ifdef __linux__
+    int fd = -1;
+#endif
+
+};
+
+#endif
@@ -0,0 +1,60 @@
+// --------------------------------------------------------------------------
+//              snapshot.h — preallocated ring of state snapshots
+//    Any trivially copyable state (GameState) is saved and restored as one
+//    memcpy into a fixed ring of N slots, tagged with the tick it was taken
+//    at. The ring is allocated with its owner, so saving never allocates;
+//    the oldest snapshot is overwritten once the ring is full.
+//
+//    Used by rollback (restore the state before a mispredicted tick) and by
+//    the single-player rewind key (step back through recent ticks).
+// --------------------------------------------------------------------------
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template<typename T, uint32_t N>
+class SnapshotRing {
+    static_assert(std::is_trivially_copyable<T>::value, "snapshots are raw byte copies");
+    static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+
+public:
+    static constexpr uint32_t capacity = N;
+    static constexpr size_t bytesPerSnapshot = sizeof(T);
+
+    SnapshotRing() { clear(); }
+
+    void clear()
+    {
+        for (uint32_t i = 0; i < N; ++i) ticks[i] = EMPTY;
+    }
+
+    void save(uint32_t tick, const T& state)
+    {
+        uint32_t i = tick & (N - 1);
+        memcpy(static_cast<void*>(&slots[i]), &state, sizeof(T));
+        ticks[i] = tick;
+    }
+
+    // False if `tick` was never saved or has been overwritten since
+    bool restore(uint32_t tick, T& state) const
+    {
+        uint32_t i = tick & (N - 1);
+        if (ticks[i] != tick) return false;
+        memcpy(static_cast<void*>(&state), &slots[i], sizeof(T));
+        return true;
+    }
+
+    bool has(uint32_t tick) const { return ticks[tick & (N - 1)] == tick; }
+
+private:
+    static const uint32_t EMPTY = 0xffffffffu;
+
+    struct alignas(64) Slot { unsigned char bytes[sizeof(T)]; };
+    Slot slots[N];
+    uint32_t ticks[N];
+};
+
+#endif
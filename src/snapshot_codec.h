@@ -0,0 +1,327 @@
+// --------------------------------------------------------------------------
+//         snapshot_codec.h — quantized, delta-coded, bit-packed states
+//    For replays, spectators and state sync, a GameState is reduced to what
+//    a viewer needs and written in tens to a few thousand bytes instead of ~50 KB:
+//      quantize   floats -> fixed-point integers over a known range
+//                 (positions over the [-1,1] world, precision configurable)
+//      delta      every field is coded against the same field of a
+//                 baseline snapshot (the previous one the receiver has):
+//                   0                    unchanged
+//                   10 + small bits      small zigzag delta
+//                   11 + full bits       new value
+//      bit-pack   fields are written back to back, no byte alignment
+//    Entities are matched with the baseline by dense index; pools are
+//    compact, so only the few entities moved by a swap-removal lose their
+//    match. Without a baseline (keyframe) fields code against zero.
+//
+//    Encoding is lossy: the decoded state is for display, not for
+//    simulation (the RNG and particle velocities are not carried).
+// --------------------------------------------------------------------------
+#ifndef SNAPSHOT_CODEC_H
+#define SNAPSHOT_CODEC_H
+
+#include "game_state.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+struct CodecConfig {
+    int positionBits = 12;      // over [-1,1]: ~0.0005 world units
+    int velocityBits = 10;      // ghost vx over [-GHOST_VX_RANGE, +]
+    int smallDeltaBits = 5;     // zigzag deltas below 2^bits take the short code
+};
+
+const float CODEC_GHOST_VX_RANGE = 4.0f;
+const float CODEC_PARTICLE_SIZE_MAX = 0.032f;
+
+// A snapshot in integer form; deltas are taken between two of these, so
+// encoder and decoder baselines never drift apart through float rounding
+struct QuantizedState {
+    uint32_t tick;
+    uint32_t numPlayers, lives, gameOver;
+    struct Player { uint32_t x, bulletActive, bulletX, bulletY, score; } players[MAX_PLAYERS];
+    uint32_t ghostCount, particleCount;
+    struct Ghost { uint32_t x, y, vx, phase; } ghosts[MAX_GHOSTS];
+    struct Particle { uint32_t x, y, life, size; } particles[MAX_PARTICLES];
+};
+
+// -------------------------------------------------------------- bit I/O ----
+class BitWriter {
+public:
+    std::vector<uint8_t> bytes;     // keeps its capacity across reset()
+
+    void reset() { bytes.clear(); acc = 0; used = 0; }
+
+    void put(uint32_t value, int bits)
+    {
+        acc |= (uint64_t)(value & mask(bits)) << used;
+        used += bits;
+        while (used >= 8) {
+            bytes.push_back((uint8_t)acc);
+            acc >>= 8;
+            used -= 8;
+        }
+    }
+
+    void finish()
+    {
+        if (used > 0) bytes.push_back((uint8_t)acc);
+        acc = 0;
+        used = 0;
+    }
+
+    size_t bitCount() const { return bytes.size() * 8 + used; }
+
+    static uint32_t mask(int bits) { return bits >= 32 ? 0xffffffffu : (1u << bits) - 1u; }
+
+private:
+    uint64_t acc = 0;
+    int used = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+
+    uint32_t get(int bits)
+    {
+        while (used < bits) {
+            if (p == end) { overrun = true; return 0; }
+            acc |= (uint64_t)*p++ << used;
+            used += 8;
+        }
+        uint32_t v = (uint32_t)acc & BitWriter::mask(bits);
+        acc >>= bits;
+        used -= bits;
+        return v;
+    }
+
+    bool ok() const { return !overrun; }
+
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+    uint64_t acc = 0;
+    int used = 0;
+    bool overrun = false;
+};
+
+// --------------------------------------------------------------- codec ----
+class SnapshotCodec {
+public:
+    CodecConfig config;
+
+    void quantize(const GameState& g, QuantizedState& q) const
+    {
+        memset(static_cast<void*>(&q), 0, sizeof(q));
+        q.tick = g.tick;
+        q.numPlayers = (uint32_t)g.numPlayers;
+        q.lives = (uint32_t)std::max(0, g.lives);
+        q.gameOver = g.gameOver ? 1 : 0;
+        for (int p = 0; p < g.numPlayers; ++p) {
+            const PlayerState& s = g.players[p];
+            q.players[p].x = pos(s.x);
+            q.players[p].bulletActive = s.bulletActive ? 1 : 0;
+            q.players[p].bulletX = s.bulletActive ? pos(s.bulletX) : 0;
+            q.players[p].bulletY = s.bulletActive ? pos(s.bulletY) : 0;
+            q.players[p].score = (uint32_t)s.score;
+        }
+        const GhostArchetype& ghosts = g.world;
+        q.ghostCount = ghosts.count;
+        for (uint32_t i = 0; i < ghosts.count; ++i) {
+            q.ghosts[i].x = pos(ghosts.column<GhostX>()[i].v);
+            q.ghosts[i].y = pos(ghosts.column<GhostY>()[i].v);
+            q.ghosts[i].vx = toFixed(ghosts.column<GhostVX>()[i].v, -CODEC_GHOST_VX_RANGE, CODEC_GHOST_VX_RANGE, config.velocityBits);
+            q.ghosts[i].phase = toFixed(ghosts.column<GhostPhase>()[i].v, 0.0f, 6.28318f, 8);
+        }
+        const ParticleArchetype& parts = g.world;
+        q.particleCount = parts.count;
+        for (uint32_t i = 0; i < parts.count; ++i) {
+            const Position& p = parts.column<Position>()[i];
+            const ParticleLife& l = parts.column<ParticleLife>()[i];
+            q.particles[i].x = pos(p.x);
+            q.particles[i].y = pos(p.y);
+            q.particles[i].life = toFixed(l.life, 0.0f, 1.0f, 8);
+            q.particles[i].size = toFixed(l.size, 0.0f, CODEC_PARTICLE_SIZE_MAX, 6);
+        }
+    }
+
+    // Rebuilds a displayable GameState (fresh entity pools)
+    void dequantize(const QuantizedState& q, GameState& g) const
+    {
+        memset(static_cast<void*>(&g), 0, sizeof(g));
+        g.tick = q.tick;
+        g.numPlayers = (int32_t)q.numPlayers;
+        g.lives = (int32_t)q.lives;
+        g.gameOver = (int32_t)q.gameOver;
+        for (uint32_t p = 0; p < q.numPlayers; ++p) {
+            PlayerState& s = g.players[p];
+            s.x = unpos(q.players[p].x);
+            s.bulletActive = (int32_t)q.players[p].bulletActive;
+            s.bulletX = s.bulletActive ? unpos(q.players[p].bulletX) : 0.0f;
+            s.bulletY = s.bulletActive ? unpos(q.players[p].bulletY) : -1.5f;
+            s.score = (int32_t)q.players[p].score;
+        }
+        GhostArchetype& ghosts = g.world.get<GhostArchetype>();
+        for (uint32_t i = 0; i < q.ghostCount; ++i) {
+            int e = ghosts.spawn();
+            ghosts.get<GhostX>(e).v = unpos(q.ghosts[i].x);
+            ghosts.get<GhostY>(e).v = unpos(q.ghosts[i].y);
+            ghosts.get<GhostVX>(e).v = fromFixed(q.ghosts[i].vx, -CODEC_GHOST_VX_RANGE, CODEC_GHOST_VX_RANGE, config.velocityBits);
+            ghosts.get<GhostPhase>(e).v = fromFixed(q.ghosts[i].phase, 0.0f, 6.28318f, 8);
+        }
+        ParticleArchetype& parts = g.world.get<ParticleArchetype>();
+        for (uint32_t i = 0; i < q.particleCount; ++i) {
+            int e = parts.spawn();
+            parts.get<Position>(e) = Position{ unpos(q.particles[i].x), unpos(q.particles[i].y) };
+            parts.get<Velocity>(e) = Velocity{ 0.0f, 0.0f };
+            parts.get<ParticleLife>(e) = ParticleLife{ fromFixed(q.particles[i].life, 0.0f, 1.0f, 8),
+                                                       fromFixed(q.particles[i].size, 0.0f, CODEC_PARTICLE_SIZE_MAX, 6) };
+        }
+        g.world.flush();
+    }
+
+    // base == nullptr writes a keyframe
+    void encode(const QuantizedState& q, const QuantizedState* base, BitWriter& out) const
+    {
+        const QuantizedState& b = base ? *base : zero();
+        out.reset();
+        out.put(q.tick, 32);
+        out.put(base ? 1 : 0, 1);
+        field(out, q.numPlayers, b.numPlayers, 2);
+        field(out, q.lives, b.lives, 8);
+        field(out, q.gameOver, b.gameOver, 1);
+        for (uint32_t p = 0; p < q.numPlayers; ++p) {
+            const QuantizedState::Player& c = q.players[p];
+            const QuantizedState::Player& o = b.players[p];
+            field(out, c.x, o.x, config.positionBits);
+            field(out, c.bulletActive, o.bulletActive, 1);
+            if (c.bulletActive) {
+                field(out, c.bulletX, o.bulletX, config.positionBits);
+                field(out, c.bulletY, o.bulletY, config.positionBits);
+            }
+            field(out, c.score, o.score, 32);
+        }
+        field(out, q.ghostCount, b.ghostCount, COUNT_BITS);
+        for (uint32_t i = 0; i < q.ghostCount; ++i) {
+            const QuantizedState::Ghost& c = q.ghosts[i];
+            const QuantizedState::Ghost& o = i < b.ghostCount ? b.ghosts[i] : zero().ghosts[0];
+            field(out, c.x, o.x, config.positionBits);
+            field(out, c.y, o.y, config.positionBits);
+            field(out, c.vx, o.vx, config.velocityBits);
+            field(out, c.phase, o.phase, 8);
+        }
+        field(out, q.particleCount, b.particleCount, COUNT_BITS);
+        for (uint32_t i = 0; i < q.particleCount; ++i) {
+            const QuantizedState::Particle& c = q.particles[i];
+            const QuantizedState::Particle& o = i < b.particleCount ? b.particles[i] : zero().particles[0];
+            field(out, c.x, o.x, config.positionBits);
+            field(out, c.y, o.y, config.positionBits);
+            field(out, c.life, o.life, 8);
+            field(out, c.size, o.size, 6);
+        }
+        out.finish();
+    }
+
+    // False on truncated or inconsistent input (e.g. a delta without its
+    // baseline); q is then undefined
+    bool decode(const uint8_t* data, size_t size, const QuantizedState* base, QuantizedState& q) const
+    {
+        BitReader in(data, size);
+        q.tick = in.get(32);
+        bool isDelta = in.get(1) != 0;
+        if (isDelta && !base) return false;
+        const QuantizedState& b = isDelta ? *base : zero();
+        q.numPlayers = field(in, b.numPlayers, 2);
+        q.lives = field(in, b.lives, 8);
+        q.gameOver = field(in, b.gameOver, 1);
+        if (q.numPlayers > (uint32_t)MAX_PLAYERS) return false;
+        memset(q.players, 0, sizeof(q.players));
+        for (uint32_t p = 0; p < q.numPlayers; ++p) {
+            QuantizedState::Player& c = q.players[p];
+            const QuantizedState::Player& o = b.players[p];
+            c.x = field(in, o.x, config.positionBits);
+            c.bulletActive = field(in, o.bulletActive, 1);
+            if (c.bulletActive) {
+                c.bulletX = field(in, o.bulletX, config.positionBits);
+                c.bulletY = field(in, o.bulletY, config.positionBits);
+            }
+            c.score = field(in, o.score, 32);
+        }
+        q.ghostCount = field(in, b.ghostCount, COUNT_BITS);
+        if (q.ghostCount > (uint32_t)MAX_GHOSTS) return false;
+        for (uint32_t i = 0; i < q.ghostCount; ++i) {
+            QuantizedState::Ghost& c = q.ghosts[i];
+            const QuantizedState::Ghost& o = i < b.ghostCount ? b.ghosts[i] : zero().ghosts[0];
+            c.x = field(in, o.x, config.positionBits);
+            c.y = field(in, o.y, config.positionBits);
+            c.vx = field(in, o.vx, config.velocityBits);
+            c.phase = field(in, o.phase, 8);
+        }
+        q.particleCount = field(in, b.particleCount, COUNT_BITS);
+        if (q.particleCount > (uint32_t)MAX_PARTICLES) return false;
+        for (uint32_t i = 0; i < q.particleCount; ++i) {
+            QuantizedState::Particle& c = q.particles[i];
+            const QuantizedState::Particle& o = i < b.particleCount ? b.particles[i] : zero().particles[0];
+            c.x = field(in, o.x, config.positionBits);
+            c.y = field(in, o.y, config.positionBits);
+            c.life = field(in, o.life, 8);
+            c.size = field(in, o.size, 6);
+        }
+        return in.ok();
+    }
+
+private:
+    static const int COUNT_BITS = 11;   // up to MAX_PARTICLES
+    static_assert(MAX_PARTICLES < (1 << COUNT_BITS) && MAX_GHOSTS < (1 << COUNT_BITS), "entity counts must fit");
+
+    static const QuantizedState& zero()
+    {
+        static const QuantizedState z = {};
+        return z;
+    }
+
+    static uint32_t toFixed(float v, float lo, float hi, int bits)
+    {
+        float t = (v - lo) / (hi - lo);
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        return (uint32_t)(t * (float)BitWriter::mask(bits) + 0.5f);
+    }
+    static float fromFixed(uint32_t q, float lo, float hi, int bits)
+    {
+        return lo + (hi - lo) * (float)q / (float)BitWriter::mask(bits);
+    }
+    uint32_t pos(float v) const { return toFixed(v, -1.0f, 1.0f, config.positionBits); }
+    float unpos(uint32_t q) const { return fromFixed(q, -1.0f, 1.0f, config.positionBits); }
+
+    // delta of two `bits`-wide values, sign-extended, then zigzagged
+    static uint32_t zigzag(uint32_t value, uint32_t base, int bits)
+    {
+        int32_t d = (int32_t)((value - base) << (32 - bits)) >> (32 - bits);
+        return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+    }
+
+    void field(BitWriter& out, uint32_t value, uint32_t base, int bits) const
+    {
+        if (value == base) { out.put(0, 1); return; }
+        uint32_t zz = zigzag(value, base, bits);
+        if (config.smallDeltaBits < bits && zz < (1u << config.smallDeltaBits)) {
+            out.put(1, 1); out.put(0, 1);
+            out.put(zz, config.smallDeltaBits);
+        } else {
+            out.put(1, 1); out.put(1, 1);
+            out.put(value, bits);
+        }
+    }
+
+    uint32_t field(BitReader& in, uint32_t base, int bits) const
+    {
+        if (!in.get(1)) return base;
+        if (in.get(1)) return in.get(bits);
+        uint32_t zz = in.get(config.smallDeltaBits);
+        int32_t d = (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1);
+        return (base + (uint32_t)d) & BitWriter::mask(bits);
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+// --------------------------------------------------------------------------
+//            soak.h — long-run frame time, allocation and memory stats
+//    For hours-long headless runs:
+//      FrameHistogram   log-bucketed frame times (~12% buckets), so
+//                       percentiles over millions of frames cost a few KB
+//      soakAllocs/Frees counted by the global operator new/delete that
+//                       main.cpp replaces; steady-state play should not
+//                       allocate at all
+//      residentBytes()  current RSS, for spotting slow leaks
+// --------------------------------------------------------------------------
+#ifndef SOAK_H
+#define SOAK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// the counting new/delete must stay out of line, or GCC pairs the inlined
+// malloc/free with the new/delete expressions and warns about a mismatch
+#if defined(__GNUC__) || defined(__clang__)
+#define SOAK_NOINLINE __attribute__((noinline))
+#else
+#define SOAK_NOINLINE
+#endif
+
+inline std::atomic<uint64_t> soakAllocs{ 0 };
+inline std::atomic<uint64_t> soakFrees{ 0 };
+
+class FrameHistogram {
+public:
+    void add(uint64_t ns)
+    {
+        buckets[bucketOf(ns)]++;
+        count++;
+        if (ns > maxNs) maxNs = ns;
+    }
+
+    void reset() { *this = FrameHistogram(); }
+
+    // upper bound of the bucket holding the p-th percentile (0..100)
+    uint64_t percentile(double p) const
+    {
+        if (!count) return 0;
+        uint64_t rank = (uint64_t)(p / 100.0 * (double)(count - 1)) + 1, seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return upperOf(i) < maxNs ? upperOf(i) : maxNs;
+        }
+        return maxNs;
+    }
+
+    uint64_t frames() const { return count; }
+    uint64_t max() const { return maxNs; }
+
+private:
+    // 16 exact buckets below 16 ns, then 8 per power of two up to 2^40 ns
+    static const int BUCKETS = 16 + 37 * 8;
+    uint64_t buckets[BUCKETS] = {};
+    uint64_t count = 0, maxNs = 0;
+
+    static int log2of(uint64_t v)
+    {
+        int e = 0;
+        while (v >>= 1) e++;
+        return e;
+    }
+    static int bucketOf(uint64_t ns)
+    {
+        if (ns < 16) return (int)ns;
+        int e = log2of(ns);
+        if (e > 40) return BUCKETS - 1;
+        int b = 16 + (e - 4) * 8 + (int)((ns >> (e - 3)) & 7);
+        return b < BUCKETS ? b : BUCKETS - 1;
+    }
+    static uint64_t upperOf(int i)
+    {
+        if (i < 16) return (uint64_t)i;
+        int e = (i - 16) / 8 + 4, sub = (i - 16) % 8;
+        return ((uint64_t)(9 + sub) << (e - 3)) - 1;
+    }
+};
+
+// Resident set size in bytes, 0 where it cannot be read
+inline size_t residentBytes()
+{
+#ifndef _WIN32
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long pages = 0, resident = 0;
+    int n = fscanf(f, "%lu %lu", &pages, &resident);
+    fclose(f);
+    return n == 2 ? (size_t)resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,58 @@
+// --------------------------------------------------------------------------
+//           spsc_queue.h — bounded lock-free single-producer queue
+//    One thread pushes, one thread pops; the two indices live on separate
+//    cache lines and each is written by one side only (release) and read
+//    by the other (acquire). Capacity is a power of two, fixed at compile
+//    time; push() fails instead of blocking when full.
+// --------------------------------------------------------------------------
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+template<typename T, uint32_t N>
+class SpscQueue {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "items are copied by value");
+
+public:
+    static constexpr uint32_t capacity = N;
+
+    // producer
+    bool push(const T& item)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N) return false;
+        items[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: look at the oldest item without taking it
+    const T* peek() const
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return nullptr;
+        return &items[h & (N - 1)];
+    }
+
+    bool pop(T& item)
+    {
+        const T* p = peek();
+        if (!p) return false;
+        item = *p;
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t size() const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+
+private:
+    alignas(64) std::atomic<uint32_t> head{ 0 };    // written by the consumer
+    alignas(64) std::atomic<uint32_t> tail{ 0 };    // written by the producer
+    alignas(64) T items[N];
+};
+
+#endif
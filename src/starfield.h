@@ -0,0 +1,63 @@
+// --------------------------------------------------------------------------
+//              starfield.h — GPU-only parallax starfield
+//    Star state is never stored: starfield.vs derives each star from its
+//    instance index and the star clock. The CPU cost is one uniform and one
+//    instanced draw, whatever the star count.
+// --------------------------------------------------------------------------
+#ifndef STARFIELD_H
+#define STARFIELD_H
+
+#include "glad.h"
+#include "shader_m.h"
+
+class Starfield {
+public:
+    Shader* shader = nullptr;
+    int   count = 120;
+    float time = 0.0f;      // advances only while the game runs, like the old stars
+
+    void initGL(int starCount)
+    {
+        count = starCount;
+        shader = new Shader("resources/shaders/starfield.vs", "resources/shaders/starfield.fs");
+        // no attributes, but core profile still wants a VAO bound to draw
+        glGenVertexArrays(1, &vao);
+        lookupUniforms();
+    }
+
+    // after a hot reload the program (and its uniform locations) changed
+    void lookupUniforms()
+    {
+        uTime = glGetUniformLocation(shader->ID, "time");
+        uViewOffset = glGetUniformLocation(shader->ID, "viewOffset");
+        uGlow = glGetUniformLocation(shader->ID, "glow");
+        uDepth = glGetUniformLocation(shader->ID, "depth");
+    }
+
+    void update(float dt) { time += dt; }
+    void reset() { time = 0.0f; }
+
+    void draw(float viewX, float viewY, float depth = 0.0f)
+    {
+        shader->use();
+        glUniform1f(uDepth, depth);
+        glUniform1f(uTime, time);
+        glUniform2f(uViewOffset, viewX, viewY);
+        glUniform1f(uGlow, 1.2f);
+        glBindVertexArray(vao);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, count);
+    }
+
+    void destroyGL()
+    {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(shader->ID);
+        delete shader;
+    }
+
+private:
+    unsigned int vao = 0;
+    int uTime = -1, uViewOffset = -1, uGlow = -1, uDepth = -1;
+};
+
+#endif
@@ -0,0 +1,77 @@
+// --------------------------------------------------------------------------
+//            trails.h — motion trails from an accumulation buffer
+//    A persistent HDR texture is faded every frame (a multiplicative blend,
+//    no read-back) and the trail layers are added on top of what is left.
+//    The scene then adds the texture back in from an additive layer.
+//    Trail length comes from the fade rate, not from extra geometry, so
+//    the cost is one full-screen fade + one full-screen add however many
+//    objects leave trails.
+// --------------------------------------------------------------------------
+#ifndef TRAILS_H
+#define TRAILS_H
+
+#include "glad.h"
+#include "shader_m.h"
+#include "frame_graph.h"
+#include <cmath>
+
+class Trails {
+public:
+    float persistence = 0.86f;      // fraction kept per 1/60 s
+    float intensity = 0.9f;
+    Shader* blit = nullptr;
+
+    void initGL()
+    {
+        blit = new Shader("resources/shaders/post.vs", "resources/shaders/trails.fs");
+        glGenVertexArrays(1, &vao);
+    }
+
+    // Fade the buffer and add drawLayers() into it; returns the buffer for
+    // the scene pass to read (and composite() in)
+    template<typename DrawFn>
+    FGResource addPass(FrameGraph& fg, float dt, DrawFn drawLayers)
+    {
+        FGResource buffer = fg.createPersistent("trails", FGTextureDesc());
+        float keep = std::pow(persistence, dt * 60.0f);
+        fg.addPass("trails", {}, buffer, [this, keep, drawLayers](FrameGraph&) {
+            glEnable(GL_BLEND);
+            // dst *= keep; the shader output is ignored (src factor zero)
+            glBlendColor(0.0f, 0.0f, 0.0f, keep);
+            glBlendFunc(GL_ZERO, GL_CONSTANT_ALPHA);
+            glBindVertexArray(vao);
+            blit->use();
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            // layers accumulate additively (colors are premultiplied)
+            glBlendFunc(GL_ONE, GL_ONE);
+            drawLayers();
+            glDisable(GL_BLEND);
+        });
+        return buffer;
+    }
+
+    // Inside the scene pass, from an additive layer: add the trails on top
+    void composite(FrameGraph& g, FGResource buffer, float depth)
+    {
+        glBindVertexArray(vao);
+        blit->use();
+        blit->setFloat("depth", depth);
+        blit->setInt("source", 0);
+        blit->setFloat("intensity", intensity);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, g.texture(buffer));
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    void destroyGL()
+    {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(blit->ID);
+        delete blit;
+    }
+
+private:
+    GLuint vao = 0;
+};
+
+#endif
@@ -0,0 +1,46 @@
+// --------------------------------------------------------------------------
+//         triple_buffer.h — latest-value handoff between two threads
+//    Three slots: the producer fills its back slot and publish()es it by
+//    swapping it with the shared middle slot; the consumer's acquire()
+//    swaps its front slot with the middle one if something new is there.
+//    Neither side ever waits or sees a half-written value: a slow consumer
+//    just skips to the newest one, a slow producer leaves the consumer
+//    showing the last one again. The middle index carries a "fresh" bit
+//    so acquire() only swaps when there is something to take.
+// --------------------------------------------------------------------------
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+template<typename T>
+class TripleBuffer {
+public:
+    // ---- producer ----
+    T& back() { return slots[backIndex]; }
+
+    void publish()
+    {
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // ---- consumer ----
+    // Newest published value, or the one returned last time if none since
+    const T& acquire()
+    {
+        if (middle.load(std::memory_order_relaxed) & FRESH)
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX;
+        return slots[frontIndex];
+    }
+
+private:
+    static const uint32_t INDEX = 3, FRESH = 4;
+
+    alignas(64) T slots[3] = {};
+    alignas(64) std::atomic<uint32_t> middle{ 1 };
+    alignas(64) uint32_t backIndex = 0;     // producer only
+    alignas(64) uint32_t frontIndex = 2;    // consumer only
+};
+
+#endif
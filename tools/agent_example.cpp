@@ -0,0 +1,52 @@
+// --------------------------------------------------------------------------
+//          agent_example — minimal external agent over shared memory
+//    usage: agent_example <name>
+//    Start the game first with `--agent <name>` (add --lockstep to have it
+//    wait for every answer), then run this. Each observation is read in
+//    place from the ring; the policy walks under the lowest ghost and
+//    fires, and answers with one PlayerInput per observation.
+// --------------------------------------------------------------------------
+
+#include "../src/agent_channel.h"
+#include <cmath>
+#include <iostream>
+
+static PlayerInput policy(const AgentObservation& o)
+{
+    if (o.gameOver) return INPUT_RESTART;
+    int target = -1;
+    for (uint32_t i = 0; i < o.ghostCount && i < (uint32_t)MAX_GHOSTS; ++i)
+        if (target < 0 || o.ghostY[i] < o.ghostY[target]) target = (int)i;
+    if (target < 0) return 0;
+    float dx = o.ghostX[target] - o.playerX;
+    PlayerInput in = 0;
+    if (dx < -0.02f) in |= INPUT_LEFT;
+    if (dx > 0.02f) in |= INPUT_RIGHT;
+    if (std::fabs(dx) < 0.06f && !o.bulletActive) in |= INPUT_FIRE;
+    return in;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cout << "usage: agent_example <name>\n";
+        return 1;
+    }
+    AgentChannel channel;
+    if (!channel.attach(argv[1])) return 1;
+
+    uint64_t seen = 0, answered = 0, stale = 0;
+    for (;;) {
+        const AgentObservation* o = channel.waitObservation(seen, 3000);
+        if (!o) break;                  // game gone quiet: done
+        uint64_t seq = o->seq;
+        PlayerInput in = policy(*o);
+        if (!channel.stillValid(seq)) { stale++; seen = seq; continue; }
+        channel.sendAction(seq, in);
+        seen = seq;
+        if (++answered % 100000 == 0)
+            std::cout << "agent: " << answered << " actions, score " << o->score << "\n";
+    }
+    std::cout << "agent: " << answered << " actions, " << stale << " stale observations skipped\n";
+    return 0;
+}
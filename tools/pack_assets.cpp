@@ -0,0 +1,74 @@
+// --------------------------------------------------------------------------
+//            pack_assets — bake loose resources into one .pak
+//    usage: pack_assets <out.pak> <file>...
+//    Images (png/jpg/bmp/tga) are decoded to RGBA8 here, once, so the game
+//    never runs stb_image at startup. Other files are stored verbatim.
+// --------------------------------------------------------------------------
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "../src/asset_pack.h"
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <algorithm>
+
+static bool isImage(std::string path) {
+    std::transform(path.begin(), path.end(), path.begin(), ::tolower);
+    for (const char* ext : { ".png", ".jpg", ".jpeg", ".bmp", ".tga" }) {
+        size_t n = strlen(ext);
+        if (path.size() >= n && path.compare(path.size() - n, n, ext) == 0) return true;
+    }
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::cout << "usage: pack_assets <out.pak> <file>...\n";
+        return 1;
+    }
+    // same orientation the game uses for GL uploads
+    stbi_set_flip_vertically_on_load(true);
+
+    std::vector<PackSource> sources;
+    for (int i = 2; i < argc; ++i) {
+        PackSource src;
+        src.name = argv[i];
+        src.width = src.height = 0;
+        if (src.name.size() >= sizeof(PackEntry::name)) {
+            std::cout << "name too long: " << src.name << "\n";
+            return 1;
+        }
+        if (isImage(src.name)) {
+            int w, h, n;
+            unsigned char* px = stbi_load(argv[i], &w, &h, &n, 4);
+            if (!px) {
+                std::cout << "failed to decode " << argv[i] << ": " << stbi_failure_reason() << "\n";
+                return 1;
+            }
+            src.type = PACK_RGBA8;
+            src.width = w;
+            src.height = h;
+            src.bytes.assign(px, px + (size_t)w * h * 4);
+            stbi_image_free(px);
+        } else {
+            std::ifstream f(argv[i], std::ios::binary);
+            if (!f) {
+                std::cout << "failed to open " << argv[i] << "\n";
+                return 1;
+            }
+            src.type = PACK_RAW;
+            src.bytes.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        }
+        std::cout << "  " << src.name << "  " << src.bytes.size() << " B"
+                  << (src.type == PACK_RGBA8 ? "  (rgba8)" : "") << "\n";
+        sources.push_back(std::move(src));
+    }
+    if (!writeAssetPack(argv[1], sources)) {
+        std::cout << "failed to write " << argv[1] << "\n";
+        return 1;
+    }
+    std::cout << "wrote " << argv[1] << " (" << sources.size() << " entries)\n";
+    return 0;
+}